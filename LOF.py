@@ -2,56 +2,655 @@ from sklearn.neighbors import NearestNeighbors
 from sklearn.datasets import make_blobs
 from sklearn.metrics import precision_recall_curve, roc_curve, auc
 import numpy as np
+from collections import deque
+from concurrent.futures import ThreadPoolExecutor
+import math
+import os
+import struct
+import sys
+import time
 import matplotlib.pyplot as plt
 
+class BruteNeighbors:
+    '''
+    暴力k近邻，接口与sklearn的NearestNeighbors.kneighbors一致
+    点集中心化后按行主序存放，每行补零到ALIGN_BYTES个双精度字节对应的元素数（双精度时为64字节，
+    低精度存储时行的字节数按比例缩小）；距离用 |q|^2 + |p|^2 - 2q·p 化为分块矩阵乘，
+    由BLAS在运行时按CPU选择AVX2/AVX-512内核（不支持时回退到标量实现），选出k近邻后再精确计算其距离
+    dtype: 样本点的存储精度，float32/float16可将点集的内存与带宽减为1/2、1/4；
+           距离块按存储精度计算（float16没有BLAS内核，逐块转为float32计算），k近邻的精确距离仍用双精度
+    '''
+    ALIGN_BYTES = 64
+
+    def __init__(self, query_block=256, fit_block=4096, dtype=np.float64):
+        self.query_block = query_block  # 查询点分块大小
+        self.fit_block = fit_block  # 样本点分块大小，与查询块一起决定距离块的大小，应能放入L2缓存
+        self.dtype = dtype
+        self.fit_x_ = None
+
+    def _pad(self, x, dtype=np.float64):
+        x = np.asarray(x, dtype=np.float64)
+        padded = np.zeros((x.shape[0], self.width_), dtype=dtype)
+        padded[:, :x.shape[1]] = x - self.center_
+        return padded
+
+    def _set_index_dtype(self, n_fit):
+        self.compute_dtype_ = np.promote_types(self.fit_x_.dtype, np.float32)  # 距离块的计算精度
+        self.index_dtype_ = np.uint32 if n_fit <= np.iinfo(np.uint32).max else np.int64  # 近邻编号的类型
+
+    def fit(self, x):
+        x = np.asarray(x, dtype=np.float64)
+        self.center_ = x.mean(axis=0)  # 中心化以减小展开式的相消误差
+        align = self.ALIGN_BYTES // x.itemsize
+        self.width_ = (x.shape[1] + align - 1) // align * align
+        self.fit_x_ = self._pad(x, self.dtype)
+        self._set_index_dtype(len(x))
+        # 平方范数按量化后的点计算，与距离块中的点积一致
+        fit_x = self.fit_x_.astype(self.compute_dtype_, copy=False)
+        self.fit_sq_ = np.einsum('ij,ij->i', fit_x, fit_x)
+        return self
+
+    def fit_columns(self, columns, center, fit_sq):
+        '''
+        直接使用已中心化、按列存放的点集（如mmap映射的模型文件），不做任何拷贝
+        :param columns: 形状为(d, n)的数组
+        :param center: 中心化时减去的均值
+        :param fit_sq: 各点（中心化后）的平方范数
+        '''
+        self.center_ = center
+        self.width_ = columns.shape[0]
+        self.fit_x_ = columns.T
+        self.fit_sq_ = fit_sq
+        self._set_index_dtype(columns.shape[1])
+        return self
+
+    def one_vs_many(self, q, start=0, stop=None):
+        '''
+        单个查询点到样本点[start, stop)的平方距离
+        '''
+        q = self._pad(np.reshape(q, (1, -1)))[0].astype(self.compute_dtype_, copy=False)
+        fit_x = self.fit_x_[start:stop].astype(self.compute_dtype_, copy=False)
+        return np.maximum(self.fit_sq_[start:stop] - 2 * (fit_x @ q) + q @ q, 0)
+
+    def many_vs_many(self, q, start=0, stop=None, q_sq=None):
+        '''
+        查询块（已对齐）到样本点[start, stop)的平方距离块
+        '''
+        if q_sq is None:
+            q_sq = np.einsum('ij,ij->i', q, q)
+        d2 = self.fit_x_[start:stop].astype(q.dtype, copy=False) @ q.T
+        d2 *= -2
+        d2 += self.fit_sq_[start:stop, None]
+        d2 += q_sq[None, :]
+        return np.maximum(d2, 0, out=d2).T
+
+    def kneighbors(self, x, n_neighbors, return_distance=True):
+        assert self.fit_x_ is not None
+        n_fit = self.fit_x_.shape[0]
+        n_neighbors = min(n_neighbors, n_fit)
+        n_query = len(x)
+        distance = np.empty((n_query, n_neighbors), dtype=np.float64)
+        neighbors = np.empty((n_query, n_neighbors), dtype=self.index_dtype_)
+        for q_start in range(0, n_query, self.query_block):
+            q_stop = min(q_start + self.query_block, n_query)
+            q_exact = self._pad(x[q_start:q_stop])
+            q = q_exact.astype(self.compute_dtype_, copy=False)  # 距离块按存储精度计算
+            q_sq = np.einsum('ij,ij->i', q, q)
+            best_d2, best_idx = None, None  # 逐样本块合并的候选k近邻
+            for f_start in range(0, n_fit, self.fit_block):
+                f_stop = min(f_start + self.fit_block, n_fit)
+                d2 = self.many_vs_many(q, f_start, f_stop, q_sq)
+                idx = np.broadcast_to(np.arange(f_start, f_stop, dtype=self.index_dtype_), d2.shape)
+                if best_d2 is not None:
+                    d2 = np.concatenate([best_d2, d2], axis=1)
+                    idx = np.concatenate([best_idx, idx], axis=1)
+                if d2.shape[1] > n_neighbors:
+                    part = np.argpartition(d2, n_neighbors - 1, axis=1)[:, :n_neighbors]
+                    d2 = np.take_along_axis(d2, part, axis=1)
+                    idx = np.take_along_axis(idx, part, axis=1)
+                best_d2, best_idx = d2, idx
+            # 对选出的k近邻精确计算距离并排序
+            diff = self.fit_x_[best_idx].astype(np.float64, copy=False) - q_exact[:, None, :]
+            exact = np.sqrt(np.einsum('ijk,ijk->ij', diff, diff))
+            order = np.argsort(exact, axis=1, kind='stable')
+            distance[q_start:q_stop] = np.take_along_axis(exact, order, axis=1)
+            neighbors[q_start:q_stop] = np.take_along_axis(best_idx, order, axis=1)
+        if return_distance:
+            return distance, neighbors
+        return neighbors
+
+class HnswNeighbors:
+    '''
+    近似k近邻，基于hnswlib的HNSW图，接口与sklearn的NearestNeighbors.kneighbors一致
+    M: 每个点在图中的连边数，越大召回率越高、内存越大
+    ef_construction: 建图时的候选集大小
+    ef: 查询时的候选集大小（不小于k），越大召回率越高、查询越慢
+    n_neighbors: 查询的最大近邻数，ef在fit时按它一次设定，查询时不再修改共享的索引
+    '''
+    def __init__(self, M=16, ef_construction=200, ef=64, n_neighbors=1, njobs=1):
+        self.M = M
+        self.ef_construction = ef_construction
+        self.ef = ef
+        self.n_neighbors = n_neighbors
+        self.njobs = njobs
+        self.index_ = None
+
+    def fit(self, x):
+        import hnswlib  # 可选依赖，只在使用近似模式时需要
+        x = np.asarray(x, dtype=np.float32)
+        self.index_ = hnswlib.Index(space='l2', dim=x.shape[1])
+        self.index_.init_index(max_elements=len(x), M=self.M, ef_construction=self.ef_construction)
+        self.index_.add_items(x, np.arange(len(x)), num_threads=self.njobs)
+        # 各块在多个线程中并发查询同一索引，ef只在这里设定一次
+        self.index_.set_ef(max(self.ef, self.n_neighbors))
+        return self
+
+    def kneighbors(self, x, n_neighbors, return_distance=True):
+        assert self.index_ is not None and n_neighbors <= max(self.ef, self.n_neighbors)
+        # 外层已按块并行，这里单线程查询
+        neighbors, distance = self.index_.knn_query(np.asarray(x, dtype=np.float32), k=n_neighbors, num_threads=1)
+        neighbors = neighbors.astype(np.int64)
+        if return_distance:
+            return np.sqrt(distance, dtype=np.float64), neighbors  # l2空间返回的是平方距离
+        return neighbors
+
 class LOF:
-    def __init__(self, n_neighbors=10, metric='euclidean', contamination=0.01, njobs=1):
+    BRUTE_MIN_FEATURES = 16  # 维度超过该值时，暴力搜索快于树搜索
+    BLOCK_BYTES = 256 * 1024  # 分块计算时每块的工作集大小
+
+    def __init__(self, n_neighbors=10, metric='euclidean', contamination=0.01, njobs=1, algorithm='auto',
+                 hnsw_params=None, dtype=np.float64):
+        '''
+        algorithm: 'brute'使用BruteNeighbors，'kd_tree'/'ball_tree'使用sklearn的树搜索，
+                   'auto'在欧氏距离且维度超过BRUTE_MIN_FEATURES时使用'brute'，
+                   'hnsw'使用HnswNeighbors近似搜索
+        hnsw_params: 传给HnswNeighbors的M/ef_construction/ef参数
+        dtype: 模型的存储精度，float32/float16时暴力搜索的点集按该精度存放，radius与lrd_x_存为float32，
+               近邻编号存为uint32；decision_scores_始终为双精度。树搜索与HNSW内部的点集不受影响
+        '''
         self.n_neighbors = n_neighbors
         self.metric = metric
         self.njobs = njobs
         self.contamination = contamination
+        self.algorithm = algorithm
+        self.hnsw_params = hnsw_params or {}
+        self.dtype = dtype
         self.neighbors = None
+        self.fit_x_ = None  # 树搜索时fit传入的训练点
+
+    def _make_neighbors(self, n_features):
+        algorithm = self.algorithm
+        if algorithm == 'auto':
+            use_brute = self.metric == 'euclidean' and n_features > self.BRUTE_MIN_FEATURES
+            algorithm = 'brute' if use_brute else 'auto'
+        if algorithm == 'brute':
+            assert self.metric == 'euclidean'
+            return BruteNeighbors(dtype=self.dtype)
+        if algorithm == 'hnsw':
+            assert self.metric == 'euclidean'
+            return HnswNeighbors(n_neighbors=self.n_neighbors + 1, njobs=self.njobs, **self.hnsw_params)
+        return NearestNeighbors(n_neighbors=self.n_neighbors, metric=self.metric, algorithm=algorithm)
+
+    def _lrd(self, distance, neighbors):
+        # 可达距离 = max(到近邻的距离, 近邻的k近邻领域半径)
+        reach_distances = np.maximum(distance, self.radius[neighbors])
+        return self.n_neighbors / reach_distances.sum(axis=1)
 
     def lrd(self, x):
         assert self.neighbors != None
+        distance, neighbors = self.neighbors.kneighbors(x, self.n_neighbors + 1, self.metric)
+        return self._lrd(distance[:, 1:], neighbors[:, 1:])
+
+    def _block_size(self):
+        # 每个查询点在块内占用 距离、近邻、可达距离、近邻lrd 四行(k+1)个8字节数，整块控制在L2缓存大小内
+        return max(1, self.BLOCK_BYTES // (4 * 8 * (self.n_neighbors + 1)))
+
+    def _decision_block(self, x, out):
         distance, neighbors = self.neighbors.kneighbors(x, self.n_neighbors + 1, self.metric)
         distance, neighbors = distance[:, 1:], neighbors[:, 1:]
-        reach_distances = []
-        for i, point in enumerate(x):
-            neighbors_index = neighbors[i]
-            neighbors_radius = self.radius[neighbors_index]
-            reach_distance_i = np.concatenate(
-                [neighbors_radius[distance[i] <= neighbors_radius], distance[i][distance[i] > neighbors_radius]],
-                axis=0)
-            reach_distances.append(reach_distance_i)
-        reach_distances = np.stack(reach_distances)
-        lrd_x = self.n_neighbors / reach_distances.sum(axis=1)
-        return lrd_x
+        np.divide(self.lrd_x_[neighbors].mean(axis=-1), self._lrd(distance, neighbors), out=out)
+
+    def _run_blocks(self, n, func, block_size=None, njobs=None):
+        '''
+        将[0, n)切分为块，在线程池中对每块调用func(start, stop)
+        numpy/BLAS与sklearn的近邻查询在计算时会释放GIL，线程可以并行
+        '''
+        block_size = block_size or self._block_size()
+        njobs = njobs or self.njobs
+        if njobs == -1:
+            njobs = os.cpu_count()
+        blocks = [(start, min(start + block_size, n)) for start in range(0, n, block_size)]
+        if njobs <= 1 or len(blocks) <= 1:
+            for start, stop in blocks:
+                func(start, stop)
+            return
+        with ThreadPoolExecutor(max_workers=njobs) as pool:
+            for _ in pool.map(lambda block: func(*block), blocks):
+                pass
+
+    def decision_function_batched(self, x, out=None, block_size=None, njobs=None):
+        '''
+        分块多线程计算LOF，每块只做一次k近邻查询，结果直接写入out
+        :param out: 调用方提供的输出缓冲区，长度为len(x)，为None时新建
+        :param block_size: 每块的查询点数，为None时按缓存大小估算
+        :param njobs: 线程数，为None时使用self.njobs，-1为全部核心
+        '''
+        if out is None:
+            out = np.empty(len(x), dtype=np.float64)
+        assert out.shape == (len(x),)
+        self._run_blocks(len(x), lambda start, stop: self._decision_block(x[start:stop], out[start:stop]),
+                         block_size, njobs)
+        return out
 
     def decision_function(self, x):
-        lrd_x = self.lrd(x)
-        distance, neighbors = self.neighbors.kneighbors(x, self.n_neighbors + 1, self.metric)
-        neighbors = neighbors[:, 1:]
-        lof = self.lrd_x_[neighbors].mean(axis=-1) / lrd_x
-        return lof
+        return self.decision_function_batched(x)
+
+    @staticmethod
+    def _percentile(a, q):
+        '''
+        与np.percentile默认的线性插值结果相同，但只用np.partition选出相邻的两个顺序统计量，不做排序
+        '''
+        rank = (len(a) - 1) * (q / 100)
+        lo = int(np.floor(rank))
+        hi = min(lo + 1, len(a) - 1)
+        part = np.partition(a, (lo, hi))
+        low, high, t = part[lo], part[hi], rank - lo
+        # 与numpy的插值公式一致：t >= 0.5时从上端点往回插值
+        return high - (high - low) * (1 - t) if t >= 0.5 else low + (high - low) * t
 
     def fit(self, x):
-        self.neighbors = NearestNeighbors(n_neighbors=self.n_neighbors, metric=self.metric).fit(x)
-        distance, neighbors = self.neighbors.kneighbors(x, self.n_neighbors + 1, self.metric)
-        distance, neighbors = distance[:, 1:], neighbors[:, 1:]
-        self.radius = distance.max(axis=-1)  # k近邻领域半径
-        self.lrd_x_ = self.lrd(x)  # 局部可达密度
-        self.decision_scores_ = self.decision_function(x)
-        self.threshold_ = np.percentile(self.decision_scores_, (1 - self.contamination) * 100)
+        '''
+        分阶段训练：k近邻 -> 领域半径 -> lrd -> LOF -> 阈值，每个阶段依赖上一阶段的全部结果；
+        耗时的k近邻与lrd阶段按块分配给线程池，领域半径与LOF只是一次归约或查表，在当前线程中计算；
+        训练点的k近邻只查询一次，供后续各阶段复用
+        '''
+        n, k = len(x), self.n_neighbors
+        self.neighbors = self._make_neighbors(x.shape[1]).fit(x)
+        # sklearn的近邻结构不公开训练点，只为它保留调用方数组的引用；暴力搜索与HNSW可从自身的结构取回训练点
+        self.fit_x_ = None if isinstance(self.neighbors, (BruteNeighbors, HnswNeighbors)) else x
+        # 低精度模型的领域半径与lrd用float32存放（lrd可能超出float16的范围），近邻编号用uint32存放
+        state_dtype = np.promote_types(self.dtype, np.float32)
+        index_dtype = np.int64 if np.dtype(self.dtype) == np.float64 or n > np.iinfo(np.uint32).max else np.uint32
+        distance = np.empty((n, k), dtype=np.float64)
+        self.neighbors_ = np.empty((n, k), dtype=index_dtype)  # 训练点的k近邻
+
+        def query(start, stop):
+            block_distance, block_neighbors = self.neighbors.kneighbors(x[start:stop], k + 1, self.metric)
+            distance[start:stop] = block_distance[:, 1:]  # 第一个近邻是点自身
+            self.neighbors_[start:stop] = block_neighbors[:, 1:]
+        self._run_blocks(n, query)
+        self.radius = distance.max(axis=-1).astype(state_dtype, copy=False)  # k近邻领域半径
+        lrd = np.empty(n, dtype=np.float64)  # 双精度的lrd，作为LOF的分母
+
+        def local_density(start, stop):
+            lrd[start:stop] = self._lrd(distance[start:stop], self.neighbors_[start:stop])
+        self._run_blocks(n, local_density)
+        self.lrd_x_ = lrd.astype(state_dtype, copy=False)  # 局部可达密度
+        self.decision_scores_ = np.empty(n, dtype=np.float64)
+
+        def score(start, stop):
+            np.divide(self.lrd_x_[self.neighbors_[start:stop]].mean(axis=-1), lrd[start:stop],
+                      out=self.decision_scores_[start:stop])
+        self._run_blocks(n, score, njobs=1)  # 分块只为限制查表的临时数组大小
+        self.threshold_ = self._percentile(self.decision_scores_, (1 - self.contamination) * 100)
         self.labels_ = (self.decision_scores_ >= self.threshold_).astype(int)
         return self
 
+    def _fit_points(self):
+        '''
+        取回训练点，形状为(n, d)；暴力搜索与HNSW从近邻结构中取回，不另存一份训练点
+        暴力搜索时为补齐、中心化后的存储还原的点（低精度存储时带有量化误差）；树搜索时为fit传入的数组
+        '''
+        if isinstance(self.neighbors, BruteNeighbors):
+            d = len(self.neighbors.center_)
+            return self.neighbors.fit_x_[:, :d].astype(np.float64) + self.neighbors.center_
+        if isinstance(self.neighbors, HnswNeighbors):
+            return np.asarray(self.neighbors.index_.get_items(np.arange(len(self.neighbors_))), dtype=np.float64)
+        return self.fit_x_
+
+    def _index_nbytes(self):
+        '''
+        近邻结构的字节数：暴力搜索为补齐后的点集与平方范数，HNSW为索引序列化后的大小，
+        树搜索只计训练点（树自身的数组不是sklearn的公开接口，不计入）
+        '''
+        if isinstance(self.neighbors, BruteNeighbors):
+            return self.neighbors.fit_x_.nbytes + self.neighbors.fit_sq_.nbytes
+        if isinstance(self.neighbors, HnswNeighbors):
+            return self.neighbors.index_.index_file_size()
+        return np.asarray(self.fit_x_).nbytes
+
+    def nbytes(self):
+        '''
+        模型常驻内存的字节数：近邻结构、训练点的近邻编号、领域半径、lrd、LOF与标签
+        '''
+        return (self._index_nbytes() + self.neighbors_.nbytes + self.radius.nbytes + self.lrd_x_.nbytes +
+                self.decision_scores_.nbytes + self.labels_.nbytes)
+
     def predict(self, x):
         lof = self.decision_function(x)
         labels = np.zeros(x.shape[0])
         labels[lof >= self.threshold_] = 1
         return labels
 
+    def save(self, path):
+        '''
+        保存为可mmap的模型文件，格式见FORMAT_SECTIONS
+        '''
+        x = np.asarray(self._fit_points(), dtype=np.float64)
+        center = x.mean(axis=0)
+        columns = (x - center).T.astype(np.float32)
+        fit_sq = np.einsum('ij,ij->j', columns, columns)
+        header = (self.n_neighbors, self.threshold_, self.contamination)
+        save_sections(path, MODEL_MAGIC, x.shape, header, {
+            'points': columns, 'center': center, 'fit_sq': fit_sq, 'radius': self.radius, 'lrd': self.lrd_x_,
+            'scores': self.decision_scores_, 'neighbors': self.neighbors_})
+        return self
+
+    @classmethod
+    def load(cls, path, njobs=1):
+        '''
+        mmap加载模型文件，数组均为文件的只读视图，不做解析与拷贝，多个进程共享同一份页缓存
+        加载后的模型固定使用暴力搜索
+        '''
+        (n, d), (k, threshold, contamination), sections = load_sections(path, MODEL_MAGIC)
+        model = cls(n_neighbors=k, contamination=contamination, njobs=njobs, algorithm='brute')
+        model.neighbors = BruteNeighbors().fit_columns(sections['points'], sections['center'], sections['fit_sq'])
+        model.radius = sections['radius']
+        model.lrd_x_ = sections['lrd']
+        model.decision_scores_ = sections['scores']
+        model.neighbors_ = sections['neighbors']
+        model.threshold_ = threshold
+        model.labels_ = (model.decision_scores_ >= model.threshold_).astype(int)
+        return model
+
+# 二进制文件格式（小端序）：64字节文件头 + 各数据段，每段起点对齐到64字节，可直接mmap为numpy数组
+# 文件头: magic(8s) version(u32) reserved(u32) n(u64) d(u64) k(u64) threshold(f64) contamination(f64)
+POINTS_MAGIC = b'LOFPTS\0\0'
+MODEL_MAGIC = b'LOFMDL\0\0'
+FORMAT_VERSION = 1
+FORMAT_ALIGN = 64
+FORMAT_HEADER = struct.Struct('<8sIIQQQdd')
+# 各数据段的 (名称, 类型, 形状, 点所在的维度)；点集按列存放，点数补齐到16的倍数以保证每列起点对齐
+FORMAT_SECTIONS = {
+    POINTS_MAGIC: [('points', np.float32, lambda n, d, k: (d, n), 1)],
+    MODEL_MAGIC: [
+        ('points', np.float32, lambda n, d, k: (d, n), 1),  # 中心化后的点
+        ('center', np.float64, lambda n, d, k: (d,), None),
+        ('fit_sq', np.float32, lambda n, d, k: (n,), 0),  # 中心化后各点的平方范数
+        ('radius', np.float32, lambda n, d, k: (n,), 0),
+        ('lrd', np.float32, lambda n, d, k: (n,), 0),
+        ('scores', np.float64, lambda n, d, k: (n,), 0),  # 与threshold比较，保留双精度以免边界点的标签翻转
+        ('neighbors', np.uint32, lambda n, d, k: (n, k), 0),
+    ],
+}
+
+def _format_align(offset):
+    return (offset + FORMAT_ALIGN - 1) // FORMAT_ALIGN * FORMAT_ALIGN
+
+def save_sections(path, magic, shape, header, arrays):
+    n, d = shape
+    k, threshold, contamination = header
+    n_pad = (n + 15) // 16 * 16
+    with open(path, 'wb') as f:
+        f.write(FORMAT_HEADER.pack(magic, FORMAT_VERSION, 0, n, d, k, threshold, contamination).ljust(FORMAT_ALIGN, b'\0'))
+        for name, dtype, section_shape, _ in FORMAT_SECTIONS[magic]:
+            section = np.zeros(section_shape(n_pad, d, k), dtype=dtype)
+            array = np.asarray(arrays[name], dtype=dtype)
+            section[tuple(slice(0, size) for size in array.shape)] = array
+            f.write(b'\0' * (_format_align(f.tell()) - f.tell()))
+            f.write(section.tobytes())
+
+def load_sections(path, magic):
+    '''
+    :raises ValueError: 文件头不匹配，或数据段超出文件末尾
+    '''
+    buffer = np.memmap(path, dtype=np.uint8, mode='r')
+    if len(buffer) < FORMAT_ALIGN:
+        raise ValueError(f'{path}: file too short for the header ({len(buffer)} bytes)')
+    file_magic, version, _, n, d, k, threshold, contamination = FORMAT_HEADER.unpack_from(buffer, 0)
+    if file_magic != magic:
+        raise ValueError(f'{path}: bad magic {file_magic!r}, expected {magic!r}')
+    if version != FORMAT_VERSION:
+        raise ValueError(f'{path}: unsupported format version {version}, expected {FORMAT_VERSION}')
+    n_pad = (n + 15) // 16 * 16
+    sections = {}
+    offset = FORMAT_ALIGN
+    for name, dtype, section_shape, axis in FORMAT_SECTIONS[magic]:
+        offset = _format_align(offset)
+        shape = section_shape(n_pad, d, k)
+        nbytes = math.prod(shape) * np.dtype(dtype).itemsize  # Python整数，头部的n、d、k被篡改时也不会溢出
+        if offset + nbytes > len(buffer):
+            raise ValueError(f'{path}: section {name} [{offset}, {offset + nbytes}) exceeds file size {len(buffer)}')
+        section = np.ndarray(shape, dtype=dtype, buffer=buffer, offset=offset)
+        offset += nbytes
+        # 去掉末尾补齐的点
+        sections[name] = section if axis is None else section[(slice(None),) * axis + (slice(0, n),)]
+    return (n, d), (k, threshold, contamination), sections
+
+def save_points(path, x):
+    x = np.asarray(x)
+    save_sections(path, POINTS_MAGIC, x.shape, (0, 0.0, 0.0), {'points': x.T})
+
+def load_points(path):
+    '''
+    mmap加载点集文件，返回形状为(n, d)的只读视图（按列存放）
+    '''
+    _, _, sections = load_sections(path, POINTS_MAGIC)
+    return sections['points'].T
+
+def approximate_report(x, y, n_neighbors=20, contamination=0.01, njobs=1, **hnsw_params):
+    '''
+    对比近似(HNSW)与精确模式：k近邻召回率、AUC-ROC/AUC-PR与耗时
+    :param y: 真实标签，1为异常
+    '''
+    report = {}
+    models = {}
+    for mode, algorithm in (('exact', 'auto'), ('hnsw', 'hnsw')):
+        start = time.perf_counter()
+        model = LOF(n_neighbors=n_neighbors, contamination=contamination, njobs=njobs, algorithm=algorithm,
+                    hnsw_params=hnsw_params).fit(x)
+        fit_time = time.perf_counter() - start
+        fpr, tpr, _ = roc_curve(y, model.decision_scores_, pos_label=1)
+        precision, recall, _ = precision_recall_curve(y, model.decision_scores_, pos_label=1)
+        report[mode] = {'fit_time': fit_time, 'auc_roc': auc(fpr, tpr), 'auc_pr': auc(recall, precision)}
+        models[mode] = model
+    # k近邻召回率：精确k近邻中被近似结果找到的比例，分块计算避免 n*k*k 的中间结果
+    hits = 0
+    for start in range(0, len(x), 4096):
+        block = x[start:start + 4096]
+        exact = models['exact'].neighbors.kneighbors(block, n_neighbors + 1, False)
+        approx = models['hnsw'].neighbors.kneighbors(block, n_neighbors + 1, False)
+        hits += (exact[:, :, None] == approx[:, None, :]).any(axis=2).sum()
+    report['recall'] = float(hits) / (len(x) * (n_neighbors + 1))
+    report['speedup'] = report['exact']['fit_time'] / report['hnsw']['fit_time']
+    return report
+
+def hnsw_smoke_test(n_samples=2000, n_neighbors=20, njobs=4):
+    '''
+    用真实的hnswlib检查近似模式：多线程分块打分与单线程一致，k近邻召回率不低于0.9
+    :return: 未安装hnswlib时返回None，否则返回approximate_report的结果
+    :raises RuntimeError: 检查不通过
+    '''
+    try:
+        import hnswlib  # noqa: F401
+    except ImportError:
+        return None
+    x, _ = make_blobs(n_samples=n_samples, n_features=8, centers=5, random_state=0)
+    y = np.zeros(n_samples, dtype=int)
+    y[np.argsort(LOF(n_neighbors=n_neighbors).fit(x).decision_scores_)[-n_samples // 100:]] = 1
+    model = LOF(n_neighbors=n_neighbors, njobs=njobs, algorithm='hnsw').fit(x)
+    parallel = model.decision_function_batched(x[:500], block_size=16, njobs=njobs)
+    serial = model.decision_function_batched(x[:500], njobs=1)
+    if not np.array_equal(parallel, serial):
+        raise RuntimeError('hnsw: multi-threaded scores differ from single-threaded scores')
+    report = approximate_report(x, y, n_neighbors=n_neighbors, njobs=njobs)
+    if report['recall'] < 0.9:
+        raise RuntimeError(f"hnsw: recall {report['recall']:.3f} < 0.9")
+    return report
+
+def precision_report(x, y, n_neighbors=20, contamination=0.01, njobs=1, dtypes=(np.float32, np.float16)):
+    '''
+    对比低精度存储与双精度模型（均为暴力搜索）：AUC-ROC/AUC-PR、模型内存、训练与打分耗时，
+    以及LOF相对双精度的最大相对误差和标签一致率
+    :param y: 真实标签，1为异常
+    '''
+    report = {}
+    reference = None
+    for dtype in (np.float64,) + tuple(dtypes):
+        start = time.perf_counter()
+        model = LOF(n_neighbors=n_neighbors, contamination=contamination, njobs=njobs, algorithm='brute',
+                    dtype=dtype).fit(x)
+        fit_time = time.perf_counter() - start
+        start = time.perf_counter()
+        model.decision_function(x)
+        score_time = time.perf_counter() - start
+        fpr, tpr, _ = roc_curve(y, model.decision_scores_, pos_label=1)
+        precision, recall, _ = precision_recall_curve(y, model.decision_scores_, pos_label=1)
+        if reference is None:
+            reference = model
+        report[np.dtype(dtype).name] = {
+            'fit_time': fit_time, 'score_time': score_time, 'nbytes': model.nbytes(),
+            'auc_roc': auc(fpr, tpr), 'auc_pr': auc(recall, precision),
+            'max_rel_error': float(np.max(np.abs(model.decision_scores_ / reference.decision_scores_ - 1))),
+            'label_agreement': float(np.mean(model.labels_ == reference.labels_))}
+    return report
+
+class IncrementalLOF:
+    '''
+    增量LOF（Pokrajac et al., Incremental Local Outlier Detection for Data Streams）
+    在容量为window_size的滑动窗口上插入/删除点，只更新受影响点（及其反向k近邻）的k距离、lrd与LOF
+    '''
+    def __init__(self, n_neighbors=10, window_size=10000):
+        self.n_neighbors = n_neighbors
+        self.window_size = window_size
+        self._x = None  # 窗口内的点，按槽位存放
+        self._window = deque()  # 按到达顺序排列的存活槽位
+        self._free = list(range(window_size - 1, -1, -1))  # 空闲槽位
+        self._alive = np.zeros(window_size, dtype=bool)
+        self._knn_idx = np.full((window_size, n_neighbors), -1, dtype=np.int64)  # k近邻槽位，按距离升序
+        self._knn_dist = np.full((window_size, n_neighbors), np.inf)
+        self._knn_len = np.zeros(window_size, dtype=np.int64)
+        self._rknn = [set() for _ in range(window_size)]  # 反向k近邻
+        self.radius = np.zeros(window_size)  # k近邻领域半径
+        self.lrd_x_ = np.zeros(window_size)  # 局部可达密度
+        self.lof_x_ = np.ones(window_size)
+
+    @property
+    def decision_scores_(self):
+        return self.lof_x_[list(self._window)]
+
+    def _distances(self, point):
+        diff = self._x - point
+        dist = np.sqrt(np.einsum('ij,ij->i', diff, diff))
+        dist[~self._alive] = np.inf
+        return dist
+
+    def _set_neighbors(self, slot, dist):
+        '''
+        用到所有点的距离重设slot的k近邻
+        '''
+        for n in self._knn_idx[slot, :self._knn_len[slot]]:
+            self._rknn[n].discard(slot)
+        cnt = min(self.n_neighbors, int(np.isfinite(dist).sum()))
+        nn = np.argpartition(dist, cnt - 1)[:cnt] if cnt > 0 else np.empty(0, dtype=np.int64)
+        nn = nn[np.argsort(dist[nn], kind='stable')]
+        self._knn_len[slot] = cnt
+        self._knn_idx[slot, :cnt], self._knn_idx[slot, cnt:] = nn, -1
+        self._knn_dist[slot, :cnt], self._knn_dist[slot, cnt:] = dist[nn], np.inf
+        self.radius[slot] = dist[nn[-1]] if cnt > 0 else 0.0
+        for n in nn:
+            self._rknn[n].add(slot)
+
+    def _add_neighbor(self, slot, neighbor, dist):
+        '''
+        将neighbor插入slot的有序k近邻表，表满时挤出最远的一个
+        '''
+        cnt = self._knn_len[slot]
+        pos = np.searchsorted(self._knn_dist[slot, :cnt], dist, side='right')
+        if cnt == self.n_neighbors:
+            self._rknn[self._knn_idx[slot, cnt - 1]].discard(slot)
+            cnt -= 1
+        self._knn_idx[slot, pos + 1:cnt + 1] = self._knn_idx[slot, pos:cnt]
+        self._knn_dist[slot, pos + 1:cnt + 1] = self._knn_dist[slot, pos:cnt]
+        self._knn_idx[slot, pos], self._knn_dist[slot, pos] = neighbor, dist
+        self._knn_len[slot] = cnt + 1
+        self.radius[slot] = self._knn_dist[slot, cnt]
+        self._rknn[neighbor].add(slot)
+
+    def _update(self, changed):
+        '''
+        k近邻表发生变化的点会改变自身及反向k近邻的lrd，lrd变化的点又会改变自身及反向k近邻的LOF
+        '''
+        update_lrd = set(changed)
+        for q in changed:
+            update_lrd |= self._rknn[q]
+        update_lof = set(update_lrd)
+        with np.errstate(divide='ignore', invalid='ignore'):
+            for o in update_lrd:
+                cnt = self._knn_len[o]
+                nn = self._knn_idx[o, :cnt]
+                reach = np.maximum(self._knn_dist[o, :cnt], self.radius[nn])
+                self.lrd_x_[o] = cnt / reach.sum() if cnt > 0 else np.inf
+                update_lof |= self._rknn[o]
+            for o in update_lof:
+                cnt = self._knn_len[o]
+                nn = self._knn_idx[o, :cnt]
+                self.lof_x_[o] = self.lrd_x_[nn].mean() / self.lrd_x_[o] if cnt > 0 else 1.0
+
+    def insert(self, point):
+        '''
+        插入一个点，窗口已满时先删除最早到达的点
+        :return: (槽位, 插入时的LOF)
+        '''
+        point = np.asarray(point, dtype=np.float64).ravel()
+        if self._x is None:
+            self._x = np.zeros((self.window_size, point.shape[0]))
+        if not self._free:
+            self.delete(self._window[0])
+        slot = self._free.pop()
+        self._x[slot] = point
+        dist = self._distances(point)
+        self._set_neighbors(slot, dist)
+        # 新点比k距离更近（或k近邻表未满）的点，k近邻表中加入新点
+        gain = self._alive & ((self._knn_len < self.n_neighbors) | (dist < self.radius))
+        changed = {slot}
+        for q in np.flatnonzero(gain):
+            self._add_neighbor(q, slot, dist[q])
+            changed.add(q)
+        self._alive[slot] = True
+        self._window.append(slot)
+        self._update(changed)
+        return slot, self.lof_x_[slot]
+
+    def delete(self, slot):
+        '''
+        删除一个点，以其为k近邻的点需要重新查询k近邻
+        '''
+        assert self._alive[slot]
+        if self._window[0] == slot:
+            self._window.popleft()
+        else:
+            self._window.remove(slot)
+        self._alive[slot] = False
+        for n in self._knn_idx[slot, :self._knn_len[slot]]:
+            self._rknn[n].discard(slot)
+        self._knn_len[slot] = 0
+        affected = self._rknn[slot]
+        self._rknn[slot] = set()
+        for q in affected:
+            dist = self._distances(self._x[q])
+            dist[q] = np.inf
+            self._set_neighbors(q, dist)
+        self._free.append(slot)
+        self._update(affected)
+
+    def partial_fit(self, x):
+        '''
+        依次插入一批点
+        :return: 各点插入时的LOF
+        '''
+        return np.array([self.insert(point)[1] for point in x])
+
 # 生成数据点，inlier为正常点，outlier为人造异常
     '''
     n_samples:生成数据个数
@@ -84,7 +683,7 @@ auc_pr = auc(recall, precision)
 
 # 绘制异常分等值图，橙色为决策边界
 x, y = np.meshgrid(np.linspace(-5, 10), np.linspace(-5, 15))
-scores = lof.decision_function(np.c_[x.ravel(), y.ravel()])
+scores = lof.decision_function_batched(np.c_[x.ravel(), y.ravel()], njobs=-1)
 plt.scatter(inliers[:, 0], inliers[:, 1], c='k', s=2, zorder=10, label='inlier')
 plt.scatter(outliers[:, 0], outliers[:, 1], c='r', s=2, zorder=10, label='outlier')
 plt.contourf(x, y, scores.reshape(x.shape)*-1, cmap=plt.cm.Blues_r, levels=np.linspace(-1*scores.max(), -1*threshold, 10))
@@ -93,4 +692,9 @@ plt.contourf(x, y, scores.reshape(x.shape)*-1, colors='orange', levels=[-1*thres
 plt.legend(loc='upper right')
 plt.clabel(c, inline=True, fontsize=7)
 plt.title(f'auc-roc={auc_roc:.2f}, auc-pr={auc_pr:.2f}')
-plt.show()
\ No newline at end of file
+plt.show()
+
+# HNSW近似模式的冒烟测试，只在显式传入--hnsw-smoke-test时运行，未安装hnswlib时跳过
+if __name__ == '__main__' and '--hnsw-smoke-test' in sys.argv[1:]:
+    smoke = hnsw_smoke_test()
+    print('hnsw smoke test: ' + ('skipped (hnswlib not installed)' if smoke is None else f"recall={smoke['recall']:.3f}"))
\ No newline at end of file
@@ -0,0 +1,8 @@
+#!/bin/bash
+# 在40/96/128通道、宽度偏斜的输入上对比各版本，通道数超过40的输入含64~96宽的业务
+# 用法: bench/channels.sh 版本... （其余环境变量同run.sh）
+BENCH=$(cd "$(dirname "$0")" && pwd)
+for channels in ${CHANNELS_LIST:-40 96 128}; do
+    echo "== $channels channels"
+    CHANNELS=$channels GENARGS=${GENARGS:-150 600 4 --skew} "$BENCH/run.sh" "$@"
+done
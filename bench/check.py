@@ -0,0 +1,119 @@
+'''
+检查main.cpp的输出并计分
+用法: python3 check.py 输入文件 输出文件 [--channels 通道数] [--no-budget]
+逐个场景重放故障与输出，检查新路径连通、宽度不变、不经过故障边、不与其他业务（含故障前的原路径）冲突，
+且各结点的换通道次数不超过上限（--no-budget时不检查）；全部通过时输出 OK 与各场景存活价值占比（万分制）之和，否则抛出AssertionError
+'''
+import argparse
+
+
+def walk(service, path, edges):
+    '''
+    沿路径从起点走到终点，返回换通道的结点
+    '''
+    node = service['start']
+    changes = []
+    prev = None
+    for e, lo in path:
+        a, b = edges[e]
+        assert node in (a, b), ('disconnected', e)
+        if prev is not None and lo != prev:
+            changes.append(node)
+        prev = lo
+        node = b if node == a else a
+    assert node == service['end'], 'wrong end'
+    return changes
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('input')
+    parser.add_argument('output')
+    parser.add_argument('--channels', type=int, default=40)
+    parser.add_argument('--no-budget', action='store_true')
+    args = parser.parse_args()
+    c = args.channels
+    inp = iter(open(args.input).read().split())
+    out = iter(open(args.output).read().split())
+
+    def read():
+        return int(next(inp))
+
+    def read_out():
+        return int(next(out))
+    n, m = read(), read()
+    budget = [0] + [read() for _ in range(n)]
+    edges = [None] + [(read(), read()) for _ in range(m)]
+    base = [None]
+    for _ in range(read()):
+        start, end, steps, lo, hi, value = [read() for _ in range(6)]
+        path = [(read(), lo) for _ in range(steps)]
+        base.append(dict(start=start, end=end, width=hi - lo + 1, value=value, path=path))
+    j = len(base) - 1
+    init = sum(x['value'] for x in base[1:])
+    total = 0
+    outputs = 0
+    for _ in range(read()):
+        services = [None] + [dict(x, alive=True) for x in base[1:]]
+        occ = {}
+        used = [0] * (n + 1)
+        dead = set()
+        for i in range(1, j + 1):
+            for e, lo in services[i]['path']:
+                for ch in range(lo, lo + services[i]['width']):
+                    occ[(e, ch)] = i
+            for node in walk(services[i], services[i]['path'], edges):
+                used[node] += 1
+        while True:
+            f = read()
+            if f == -1:
+                break
+            dead.add(f)
+            killed = {occ[(f, ch)] for ch in range(1, c + 1) if (f, ch) in occ}
+            killed = {k for k in killed if services[k]['alive']}
+            for k in killed:
+                services[k]['alive'] = False
+            outputs += 1
+            done = []
+            for _ in range(read_out()):
+                sid, steps = read_out(), read_out()
+                width = services[sid]['width']
+                path = []
+                for _ in range(steps):
+                    e, lo, hi = read_out(), read_out(), read_out()
+                    assert hi - lo + 1 == width, ('width', sid)
+                    assert 1 <= lo and hi <= c
+                    assert e not in dead, ('dead edge', sid, e)
+                    path.append((e, lo))
+                assert sid in killed, ('not killed', sid)
+                assert len(set(e for e, _ in path)) == len(path), 'repeated edge'
+                changes = walk(services[sid], path, edges)
+                for e, lo in path:
+                    for ch in range(lo, lo + width):
+                        assert occ.get((e, ch), 0) in (0, sid), ('conflict', sid, e, ch, occ.get((e, ch)))
+                for node in changes:
+                    used[node] += 1
+                for e, lo in path:
+                    for ch in range(lo, lo + width):
+                        occ[(e, ch)] = sid
+                done.append((sid, path))
+            # 本次故障处理完后才释放原路径
+            for sid, path in done:
+                width = services[sid]['width']
+                keep = {(e, ch) for e, lo in path for ch in range(lo, lo + width)}
+                for e, lo in services[sid]['path']:
+                    for ch in range(lo, lo + width):
+                        if (e, ch) not in keep and occ.get((e, ch)) == sid:
+                            del occ[(e, ch)]
+                for node in walk(services[sid], services[sid]['path'], edges):
+                    used[node] -= 1
+                services[sid]['path'] = path
+                services[sid]['alive'] = True
+            for node in range(1, n + 1) if not args.no_budget else ():
+                assert used[node] <= budget[node], ('change budget', node, used[node], budget[node])
+        total += sum(x['value'] for x in services[1:] if x['alive']) * 10000 / init
+    print('OK outputs=%d score=%.0f' % (outputs, total))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,109 @@
+'''
+生成main.cpp的测试输入：随机连通图、随机起始通道放置的业务与若干故障场景
+用法: python3 gen.py 种子 [结点数] [业务数] [场景数] [--skew] [--geo] [--channels 通道数] > 输入文件
+--skew: 业务宽度偏斜（多数很窄，少数很宽，通道数不少于96时加入64~96的超宽业务），用于测试按宽度特化的窗口内核
+--geo: 结点随机分布在单位正方形内，按距离就近连边，得到直径较大的平面状拓扑
+'''
+import argparse
+import random
+from collections import deque
+
+UNIFORM_WIDTHS = [1, 2, 3, 4, 5, 8, 10, 16, 20]
+SKEWED_WIDTHS = [1, 1, 1, 1, 2, 2, 4, 8, 8, 16, 20, 30, 40]
+WIDE_WIDTHS = [64, 80, 96]
+
+
+def make_edges(r, n, m, geo):
+    edges = set()
+    if geo:
+        pts = [None] + [(r.random(), r.random()) for _ in range(n)]
+
+        def d2(a, b):
+            return (pts[a][0] - pts[b][0]) ** 2 + (pts[a][1] - pts[b][1]) ** 2
+        for i in range(2, n + 1):  # 先连到最近的已有结点，保证连通
+            j = min(range(1, i), key=lambda j: d2(i, j))
+            edges.add((j, i))
+        for _, a, b in sorted((d2(a, b), a, b) for a in range(1, n + 1) for b in range(a + 1, n + 1)):
+            if len(edges) >= m:
+                break
+            edges.add((a, b))
+    else:
+        for i in range(2, n + 1):  # 随机生成树，保证连通
+            edges.add((r.randint(1, i - 1), i))
+        while len(edges) < m:
+            a, b = r.sample(range(1, n + 1), 2)
+            edges.add((min(a, b), max(a, b)))
+    return list(edges)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('seed', type=int)
+    parser.add_argument('nodes', type=int, nargs='?', default=60)
+    parser.add_argument('services', type=int, nargs='?', default=200)
+    parser.add_argument('scenarios', type=int, nargs='?', default=4)
+    parser.add_argument('--skew', action='store_true')
+    parser.add_argument('--geo', action='store_true')
+    parser.add_argument('--channels', type=int, default=40)
+    args = parser.parse_args()
+    r = random.Random(args.seed)
+    n, c = args.nodes, args.channels
+    m = int(n * 2.2)
+    budget = [r.randint(0, 4) for _ in range(n)]  # 各结点的换通道次数上限
+    edges = make_edges(r, n, m, args.geo)
+    adj = [[] for _ in range(n + 1)]
+    for i, (a, b) in enumerate(edges, 1):
+        adj[a].append((b, i))
+        adj[b].append((a, i))
+    widths = SKEWED_WIDTHS + (WIDE_WIDTHS if c >= 96 else []) if args.skew else UNIFORM_WIDTHS
+    occ = [[0] * (c + 1) for _ in range(m + 1)]
+    services = []
+    tries = 0
+    while len(services) < args.services and tries < args.services * 20:
+        tries += 1
+        s, t = r.sample(range(1, n + 1), 2)
+        w = min(r.choice(widths), c)
+        lo = r.randint(1, c - w + 1)
+
+        def free(e):
+            return all(occ[e][ch] == 0 for ch in range(lo, lo + w))
+        # 在通道区间[lo, lo + w)全空闲的边上随机顺序BFS，业务不换通道
+        prev = {s: None}
+        q = deque([s])
+        while q:
+            u = q.popleft()
+            if u == t:
+                break
+            nb = adj[u][:]
+            r.shuffle(nb)
+            for v, e in nb:
+                if v not in prev and free(e):
+                    prev[v] = (u, e)
+                    q.append(v)
+        if t not in prev:
+            continue
+        path = []
+        u = t
+        while prev[u]:
+            path.append(prev[u][1])
+            u = prev[u][0]
+        path.reverse()
+        for e in path:
+            for ch in range(lo, lo + w):
+                occ[e][ch] = len(services) + 1
+        services.append((s, t, len(path), lo, lo + w - 1, r.randint(1, 100000), path))
+    out = [f'{n} {m}', ' '.join(map(str, budget))]
+    out += [f'{a} {b}' for a, b in edges]
+    out.append(str(len(services)))
+    for s, t, steps, lo, hi, value, path in services:
+        out.append(f'{s} {t} {steps} {lo} {hi} {value}')
+        out.append(' '.join(map(str, path)))
+    out.append(str(args.scenarios))
+    for _ in range(args.scenarios):
+        out += [str(e) for e in r.sample(range(1, m + 1), r.randint(m // 20, m // 6))]
+        out.append('-1')
+    print('\n'.join(out))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,41 @@
+#!/bin/bash
+# 按git版本对比main.cpp的得分与耗时
+# 用法: bench/run.sh 版本... （版本为任意git revision，WORKTREE表示工作区中的main.cpp）
+# 环境变量:
+#   SEEDS    生成输入的种子，默认"1 2 3 4 5"
+#   GENARGS  传给gen.py的参数，默认"60 200 4"；宽度偏斜的输入用"150 600 4 --skew"
+#   CHANNELS 每条边的通道数，默认40，同时传给gen.py、check.py与main
+#   ARGS     传给main的其余参数，例如"portfolio 1"或"batch 4"
+#   CXXFLAGS 编译参数，默认"-std=c++17 -O2"
+#   CHECKARGS 传给check.py的其余参数，例如"--no-budget"
+set -e
+BENCH=$(cd "$(dirname "$0")" && pwd)
+REPO=$(dirname "$BENCH")
+WORK=${WORK:-$(mktemp -d)}
+SEEDS=${SEEDS:-1 2 3 4 5}
+GENARGS=${GENARGS:-60 200 4}
+CHANNELS=${CHANNELS:-40}
+CXXFLAGS=${CXXFLAGS:--std=c++17 -O2}
+
+for seed in $SEEDS; do
+    python3 "$BENCH/gen.py" $seed $GENARGS --channels $CHANNELS > "$WORK/in$seed.txt"
+done
+for rev in "$@"; do
+    name=$(echo "$rev" | tr '/~^' '___')
+    if [ "$rev" = WORKTREE ]; then
+        cp "$REPO/main.cpp" "$WORK/$name.cpp"
+    else
+        git -C "$REPO" show "$rev:main.cpp" > "$WORK/$name.cpp"
+    fi
+    g++ $CXXFLAGS -o "$WORK/$name" "$WORK/$name.cpp" -lpthread
+    for seed in $SEEDS; do
+        start=$(date +%s%N)
+        if ! "$WORK/$name" /dev/null $CHANNELS $ARGS < "$WORK/in$seed.txt" > "$WORK/$name.out$seed" 2> /dev/null; then
+            echo "$rev seed $seed: crashed"
+            continue
+        fi
+        stop=$(date +%s%N)
+        result=$(python3 "$BENCH/check.py" "$WORK/in$seed.txt" "$WORK/$name.out$seed" --channels $CHANNELS $CHECKARGS 2>&1 | tail -1)
+        echo "$rev seed $seed: $result $(( (stop - start) / 1000000 ))ms"
+    done
+done
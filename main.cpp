@@ -1,1191 +1,3422 @@
-/**
- * @file main.cpp
- * @brief 2024华为嵌入式软件大赛·追光者(算法组)
- */
-
-#include <cstdint>
-#include <cstdio>
-#include <cassert>
-#include <vector>
-#include <list>
-#include <queue>
-#include <algorithm>
-using namespace std;
-
-/* LOG */
-#ifdef DEBUG // DEBUG在本地g++编译时定义，上传至官网后不会被定义
-    #define LOG_INIT(LOG_FILE_PATH) {freopen(LOG_FILE_PATH, "w+", stderr);}
-    #define LOG_INFO(arg...) {fprintf(stderr, ##arg); fflush(stderr);}
-    #define LOG_LINE() LOG_INFO("####################################################################################\n");
-    #define LOG(arg...) {fprintf(stderr, "%s:%d > ", __FILE__, __LINE__); fprintf(stderr, ##arg);}
-    #define ASSERT(state) assert(state)
-#else
-    #define LOG_INIT(...)
-    #define LOG_INFO(...)
-    #define LOG_LINE(...)
-    #define LOG(...)
-    #define ASSERT(...)
-#endif // DEBUG
-
-#define ASSERT_ID(id, vec) ASSERT(id > 0 && (id - 1) < vec.size())
-
-static constexpr uint16_t INVALID_ID = 0; // 无效ID
-
-/**
- * @brief 有编号的类型
- */
-class IdObject {
-public:
-    explicit IdObject(uint16_t id) : id(id) {}
-
-public:
-    uint16_t GetId() const {return id;}
-
-protected:
-    uint16_t id;
-};
-
-/**
- * @brief 有存活状态的类型
- */
-class LiveObject {
-public:
-    explicit LiveObject(bool isAlive = true) : isAlive(isAlive) {}
-
-public:
-    bool IsAlive() const {return isAlive;}
-    void SetAlive(bool isAlive = true) {this->isAlive = isAlive;}
-    void Kill() {SetAlive(false);}
-
-protected:
-    bool isAlive;
-};
-
-/**
- * @brief 边
- */
-class Edge : public IdObject, public LiveObject {
-public:
-    static const uint8_t CHANNELS_NUM = 40;
-
-public:
-    Edge(uint16_t id, uint16_t node1, uint16_t node2) :
-        IdObject(id), node1(node1), node2(node2), channels(CHANNELS_NUM, INVALID_ID) {}
-
-public:
-    /**
-     * @brief 获取另一个端点
-     * @param node 端点编号
-     * @return uint16_t 另一个端点的编号
-     */
-    uint16_t GetAnotherNode(uint16_t node) const {
-        ASSERT(node == node1 || node == node2);
-        return node == node1 ? node2 : node1;
-    }
-    uint16_t GetChannel(uint8_t id) const {ASSERT_ID(id, channels); return channels[id - 1];}
-    void SetChannel(uint8_t id, uint16_t service) {
-        ASSERT_ID(id, channels); 
-#ifdef DEBUG
-        if(GetChannel(id) != INVALID_ID && service != INVALID_ID && GetChannel(id) != service) {
-            LOG("[Warning] Edge[%02d](%02d): [%02d]->[%02d] Channel is not released before use!\n",
-                GetId(), id, GetChannel(id), service);
-        }
-#endif // DEBUG
-        channels[id - 1] = service;
-    }
-    void SetChannels(uint8_t startChannel, uint8_t useChannelsNum, uint16_t service) {
-        for (uint8_t i = 0; i < useChannelsNum; ++i) {
-            SetChannel(startChannel++, service);
-        }
-    }
-    bool CheckChannelFree(uint8_t channel) const {return GetChannel(channel) == INVALID_ID;}
-    bool CheckChannelsFree(uint8_t startChannel, uint8_t useChannelsNum) const {
-        ASSERT(startChannel + useChannelsNum - 1 <= Edge::CHANNELS_NUM);
-        for (uint8_t i = 0; i < useChannelsNum; ++i) {
-            if (!CheckChannelFree(startChannel + i)) {
-                return false;
-            }
-        }
-        return true;
-    }
-<<<<<<< HEAD
-    
-    /**
-     * @brief 查找空闲空间
-     * @param size 宽度
-     * @param busissnessId 业务Id 可以使用业务自身的资源
-     * @return 空区间的起点
-     */
-    uint16_t findEmptyChannel(int size){
-        uint16_t emptyBegin;
-        for(int i = 0; i < CHANNELS_NUM; i++){
-            if(channels[i] == 0){
-                int flag = 1;
-                int j;
-                for(int j = 1; j < size; j++){
-                    if(i+j < CHANNELS_NUM && channels[i+j] != 0){
-                        flag = 0;
-                        break;
-                    }
-                }
-                if(flag){
-                    emptyBegin = i;
-                    break;
-                }else{
-                    i = i+j;
-                }
-            }
-        }
-        // 通道编号是从1开始的 数组编号从0开始的
-        emptyBegin++;
-        return emptyBegin;
-=======
-    /**
-     * @brief 分配通道
-     * @param useChannelsNum 需要占用的通道数
-     * @return uint8_t 为0时代表无可用通道
-     */
-    uint8_t AllocateChannel(uint8_t useChannelsNum) {
-        ASSERT(useChannelsNum <= CHANNELS_NUM);
-        // !TODO:需要性能更佳的分配策略
-        // 采用首次适配法
-        uint8_t len = 0;
-        uint8_t endI = CHANNELS_NUM - useChannelsNum + 1; // 允许从len=0开始寻找的最晚开始位置
-        for (uint8_t i = 1; i <= CHANNELS_NUM; ++i) {
-            if (CheckChannelFree(i)) {
-                ++len;
-                if (len == useChannelsNum) {
-                    return i - (useChannelsNum - 1);
-                }
-            } else {
-                len = 0;
-                if (i > endI) { // 提前剪枝
-                    break;
-                }
-            }
-        }
-        return 0;
->>>>>>> b6a6b03c7906fe98c01e28dc2016254dd369cff1
-    }
-
-private:
-    uint16_t node1; // 编号数值较低的端点
-    uint16_t node2; // 编号数值较高的端点
-    vector<uint16_t> channels; // 占用各个通道的业务编号
-};
-
-/**
- * @brief 结点
- */
-class Node : public IdObject {
-public:
-    Node(uint16_t id, uint8_t changeChannelCntMax) :
-        IdObject(id), changeChannelCntMax(changeChannelCntMax), changeChannelCnt(0) {}
-
-public:
-    const vector<uint16_t>& GetConnectedEdges() const {return connectedEdges;}
-    uint8_t GetRemainChangeChannelCnt() const {return changeChannelCntMax - changeChannelCnt;}
-<<<<<<< HEAD
-    void addEdge(uint16_t id) {connectedEdges.push_back(id);}
-=======
-    void AddEdge(uint16_t id) {connectedEdges.push_back(id);}
-    bool IsAllowChangeChannel() const {return GetRemainChangeChannelCnt() > 0;}
-    void UseChangeChannelCnt() {
-        if (changeChannelCnt < changeChannelCntMax) {
-            ++changeChannelCnt;
-        }
-    }
-    void ReleaseChangeChannelCnt() {
-        if (changeChannelCnt > 0) {
-            --changeChannelCnt;
-        }
-    }
-
->>>>>>> b6a6b03c7906fe98c01e28dc2016254dd369cff1
-private:
-    vector<uint16_t> connectedEdges;
-    uint8_t changeChannelCntMax; // 最多可变通道数
-    uint8_t changeChannelCnt; // 可变通道数
-};
-
-/**
- * @brief 路径上的一步
- */
-class Step {
-public:
-    Step(uint16_t edge, uint16_t startNode, uint8_t startChannel, uint8_t useChannelsNum,
-         bool channelChanged = false) :
-        edge(edge), startNode(startNode), startChannel(startChannel),
-        useChannelsNum(useChannelsNum), channelChanged(channelChanged)
-    {
-        ASSERT(GetEndChannel() <= Edge::CHANNELS_NUM);
-    }
-
-public:
-    uint16_t GetEdge() const {return edge;}
-    uint16_t GetStartNode() const {return startNode;}
-    uint8_t GetStartChannel() const {return startChannel;}
-    uint8_t GetUseChannelsNum() const {return useChannelsNum;}
-    uint8_t GetEndChannel() const {return GetStartChannel() + GetUseChannelsNum() - 1;}
-    bool IsChannelChanged() const {return channelChanged;}
-
-private:
-    uint16_t edge;
-    uint16_t startNode;
-    uint8_t startChannel;
-    uint8_t useChannelsNum;
-    bool channelChanged; // 从起点处变更了通道
-};
-
-/**
- * @brief 业务
- */
-class Service : public IdObject, public LiveObject {
-public:
-    Service(uint16_t id, uint16_t start, uint16_t end, double value,
-            uint8_t defaultChannelStart, uint8_t useChannelsNum) :
-        IdObject(id), start(start), end(end), pathEnd(start), value(value),
-        defaultChannelStart(defaultChannelStart), useChannelsNum(useChannelsNum),
-        lastChannelStart(defaultChannelStart) {}
-    void AddStep(uint16_t edge, uint16_t endNode, uint8_t startChannel) {
-        path.push_back(Step(edge, pathEnd, startChannel, GetUseChannelsNum(), lastChannelStart != startChannel));
-        pathEnd = endNode;
-        lastChannelStart = startChannel;
-    }
-    void AddStep(uint16_t edge, uint16_t endNode) {
-        AddStep(edge, endNode, GetLastChannelStart());
-    }
-    double GetValue() const {return value;}
-    uint16_t GetStart() const {return start;}
-    uint16_t GetEnd() const {return end;}
-    uint8_t GetDefaultChannelStart() const {return defaultChannelStart;}
-    uint8_t GetLastChannelStart() const {return lastChannelStart;}
-    uint8_t GetUseChannelsNum() const {return useChannelsNum;}
-    uint16_t GetDefualtChannelEnd() const {return defaultChannelStart + useChannelsNum - 1;}
-    const vector<Step>& GetPath() const {return path;}
-    vector<Step> ClearPath() {
-        auto ret = path;
-        path.clear();
-        pathEnd = start;
-        lastChannelStart = defaultChannelStart;
-        return ret;
-    }
-    /**
-     * @brief 重设路径（默认为完整有效路径，不进行检查）
-     * @param path 新路径
-     */
-    void ResetPath(const vector<Step>& path) {
-        this->path = path;
-        pathEnd = end;
-        lastChannelStart = path.back().GetStartChannel();
-    }
-    bool IsPathComplete() const {return pathEnd == end;}
-    /**
-     * @brief 获取路径当前已规划到的点
-     * @return uint16_t 路径当前已规划到的点
-     */
-    uint16_t GetPathEnd() const {return pathEnd;}
-
-private:
-    uint16_t start;
-    uint16_t end;
-    vector<Step> path;
-    uint16_t pathEnd; // 路径已经规划到的点
-    double value;
-    uint8_t defaultChannelStart;
-    uint8_t useChannelsNum;
-    uint8_t lastChannelStart; // 上次添加的路径中通道的起点
-};
-
-/**
- * @brief 场景
- */
-class Scene {
-public:
-    void AddNode(uint8_t changeChannelCntMax) {nodes.push_back(Node(nodes.size() + 1, changeChannelCntMax));}
-    void CreateNodeDistanceTable(uint16_t nodesNum) {
-        ASSERT(nodeDistance == nullptr); // 只允许创建一次
-        nodeDistance = new vector<vector<uint16_t>>(nodesNum, vector<uint16_t>(nodesNum, UINT16_MAX));
-        for (uint16_t i = 0; i < nodesNum; ++i) {
-            (*nodeDistance)[i][i] = 0;
-        }
-    }
-    void DeleteNodeDistanceTable() {
-        ASSERT(nodeDistance); // 只允许在创建后调用
-        delete nodeDistance;
-    }
-    uint16_t GetNodeDistance(uint16_t node1, uint16_t node2) const {
-        ASSERT(nodeDistance);
-        ASSERT_ID(node1, nodes);
-        ASSERT_ID(node2, nodes);
-        return (*nodeDistance)[node1 - 1][node2 - 1];
-    }
-    void Floyd() {
-        for (uint16_t relay = 1; relay <= GetNodesNum(); ++relay) { // 中继点
-            for (uint16_t start = 1; start <= GetNodesNum(); ++start) { // 起点
-                for (uint16_t end = start + 1; end <= GetNodesNum(); ++end) { // 终点
-                    uint16_t dis1 = GetNodeDistance(start, relay), dis2 = GetNodeDistance(relay, end);
-                    if (dis1 == UINT16_MAX || dis2 == UINT16_MAX) {continue;}
-                    RefreshNodeDistance(start, end, dis1 + dis2);
-                }
-            }
-        }
-    }
-    void AddEdge(uint16_t node1, uint16_t node2) {
-        uint16_t id = edges.size() + 1;
-        edges.push_back(Edge(id, node1, node2));
-        GetNode(node1).AddEdge(id);
-        GetNode(node2).AddEdge(id);
-        RefreshNodeDistance(node1, node2, 1);
-    }
-    void AddService(uint16_t start, uint16_t end, double value, uint8_t startChannel, uint8_t useChannelsNum) {
-        services.push_back(Service(services.size() + 1, start, end, value, startChannel, useChannelsNum));
-    }
-    Node& GetNode(uint16_t id)                        {ASSERT_ID(id, nodes);    return nodes[id - 1];}
-    const Node& GetNodeConst(uint16_t id) const       {ASSERT_ID(id, nodes);    return nodes[id - 1];}
-    Edge& GetEdge(uint16_t id)                        {ASSERT_ID(id, edges);    return edges[id - 1];}
-    const Edge& GetEdgeConst(uint16_t id) const       {ASSERT_ID(id, edges);    return edges[id - 1];}
-    Service& GetService(uint16_t id)                  {ASSERT_ID(id, services); return services[id - 1];}
-    const Service& GetServiceConst(uint16_t id) const {ASSERT_ID(id, services); return services[id - 1];}
-    void AddServiceStep(uint16_t id, uint16_t edge, uint8_t startChannel) {
-        Service& s = GetService(id);
-        Edge& e = GetEdge(edge);
-        if (startChannel != s.GetLastChannelStart()) {
-            Node& node = GetNode(s.GetPathEnd());
-            ASSERT(node.IsAllowChangeChannel());
-            node.UseChangeChannelCnt();
-        }
-        s.AddStep(edge, e.GetAnotherNode(s.GetPathEnd()), startChannel);
-        e.SetChannels(startChannel, s.GetUseChannelsNum(), id); // 记录业务路径的同时要在边的通道中标记业务
-    }
-    void AddServiceStep(uint16_t id, uint16_t edge) {
-        Service& s = GetService(id);
-        Edge& e = GetEdge(edge);
-        s.AddStep(edge, e.GetAnotherNode(s.GetPathEnd()));
-        e.SetChannels(s.GetLastChannelStart(), s.GetUseChannelsNum(), id); // 记录业务路径的同时要在边的通道中标记业务
-    }
-    size_t GetNodesNum() const {return nodes.size();}
-    size_t GetEdgesNum() const {return edges.size();}
-    size_t GetServicesNum() const {return services.size();}
-    double GetValue() const {
-        double value = 0.0;
-        for (auto s : services) {
-            if (s.IsAlive()) {
-                value += s.GetValue();
-            }
-        }
-        return value;
-    }
-    /**
-     * 
-     */
-    void ResetChannelByPath(vector<Step> path, uint16_t id){
-        AddPath(path, id);
-    }
-    /**
-     * @brief 杀死指定边和路过的所有业务
-     * @param edge 指定边
-     * @return vector<uint16_t>&& 被杀死的业务
-     */
-    vector<uint16_t> Kill(uint16_t edge) {
-        Edge& e = GetEdge(edge);
-        e.Kill();
-        vector<uint16_t> ret;
-        for (uint8_t id = 1; id <= Edge::CHANNELS_NUM; ++id) {
-            uint16_t s = e.GetChannel(id);
-            if (s != INVALID_ID && GetService(s).IsAlive()) {
-                ret.push_back(s);
-                GetService(s).Kill();
-            }
-        }
-        return ret;
-    }
-    /**
-     * @brief 将业务路径添加到场景中
-     * @param id 业务编号
-     */
-    void AddServicePath(uint16_t id) {
-        AddPath(GetService(id).GetPath(), id);
-    }
-    /**
-     * @brief 重设业务路径
-     * @param id 业务编号
-     * @param path 新路径
-     */
-    void ResetServicePath(uint16_t id, const vector<Step>& path) {
-        GetService(id).ResetPath(path);
-        AddServicePath(id);
-    }
-    /**
-     * @brief 重设业务路径
-     * @param id 业务编号
-     * @param path 新路径
-     * @param isReverse 是否需要翻转路径
-     */
-    void ResetServicePath(uint16_t id, vector<Step> path, bool isReverse) {
-        if (isReverse) {
-            reverse(path.begin(), path.end());
-        }
-        ResetServicePath(id, path);
-    }
-    /**
-     * @brief 隐藏业务路径
-     * @param id 需要隐藏的业务
-     */
-    void HideServicePath(uint16_t id) {
-        auto path = GetService(id).ClearPath();
-        DeletePath(path);
-        servicesHided.push_back(make_pair(id, path));
-    }
-    /**
-     * @brief 恢复被隐藏的路径，如果没有被隐藏过则不做任何操作
-     * @param id 被隐藏的业务
-     */
-    void RecoverServicePath(uint16_t id) {
-        for (auto it = servicesHided.begin(); it != servicesHided.end(); ++it) {
-            if (it->first == id) {
-                ResetServicePath(id, it->second);
-                break;
-            }
-        }
-    }
-    /**
-     * @brief 恢复被隐藏的路径，如果没有被隐藏过则不做任何操作
-     * @param id 被隐藏的业务
-     * @param resetServicePath 恢复时是否需要覆盖业务中已存储的路径
-     */
-    void RecoverServicePath(uint16_t id, bool resetServicePath) {
-        for (auto it = servicesHided.begin(); it != servicesHided.end(); ++it) {
-            if (it->first == id) {
-                if (resetServicePath) {
-                    ResetServicePath(id, it->second);
-                } else {
-                    AddPath(it->second, id);
-                }
-                break;
-            }
-        }
-    }
-    /**
-     * @brief 删除路径隐藏记录
-     * @param id 被隐藏的业务
-     * @param reDelete 是否需要再执行一次删除操作
-     */
-    void DeleteHidedPath(uint16_t id, bool reDelete = false) {
-        for (auto it = servicesHided.begin(); it != servicesHided.end(); ++it) {
-            if (it->first == id) {
-                if (reDelete) {
-                    DeletePath(it->second);
-                }
-                servicesHided.erase(it);
-                break;
-            }
-        }
-    }
-    /**
-     * @brief 清空被隐藏的路径
-     * @param reDelete 是否需要再执行一次删除操作
-     */
-    void ClearHidedPath(bool reDelete = false) {
-        if (reDelete) {
-            for (auto it : servicesHided) {
-                DeletePath(it.second);
-            }
-        }
-        servicesHided.clear();
-    }
-
-private:
-    void AddPath(const vector<Step>& path, uint16_t id) {
-        for (auto step : path) {
-            GetEdge(step.GetEdge()).SetChannels(step.GetStartChannel(), step.GetUseChannelsNum(), id);
-            if (step.IsChannelChanged()) {
-                GetNode(step.GetStartNode()).UseChangeChannelCnt();
-            }
-        }
-    }
-    void DeletePath(const vector<Step>& path) {
-        for (auto step : path) {
-            GetEdge(step.GetEdge()).SetChannels(step.GetStartChannel(), step.GetUseChannelsNum(), INVALID_ID);
-            if (step.IsChannelChanged()) {
-                GetNode(step.GetStartNode()).ReleaseChangeChannelCnt();
-            }
-        }
-    }
-    void RefreshNodeDistance(uint16_t node1, uint16_t node2, uint16_t distance) {
-        if (distance < GetNodeDistance(node1, node2)) {
-            (*nodeDistance)[node1 - 1][node2 - 1] = distance;
-            (*nodeDistance)[node2 - 1][node1 - 1] = distance;
-        }
-    }
-
-private:
-    vector<Node> nodes; // 结点表
-    vector<Edge> edges; // 边表
-    vector<Service> services; // 业务表
-    vector<pair<uint16_t, vector<Step>>> servicesHided; // 隐藏的业务表路径
-    vector<vector<uint16_t>>* nodeDistance = nullptr; // 结点距离表
-};
-
-/**
- * @brief 解决方案
- */
-class Solution {
-public:
-    Solution(const Scene& s) : s(s) {}
-
-public:
-    void Handle(uint16_t edge) {
-        vector<uint16_t> services = s.Kill(edge);
-        vector<uint16_t> output;
-        sort(services.begin(), services.end(), [=] (uint16_t sid1, uint16_t sid2) {
-            return ServiceCompare(s.GetServiceConst(sid1), s.GetServiceConst(sid2));
-        });
-        Planning(services, output);
-        for (auto sid : output) {
-            s.GetService(sid).SetAlive();
-        }
-        PrintAns(output);
-    }
-    double GetValue() const {
-        return s.GetValue();
-    }
-
-protected:
-    Scene s;
-
-private:
-    /**
-     * @brief 业务比较函数
-     * @param s1 业务1
-     * @param s2 业务2
-     * @return true 在排序时将业务1放在前面
-     * @return false 在排序时将业务2放在前面
-     */
-    virtual bool ServiceCompare(const Service& s1, const Service& s2) const  = 0;
-    /**
-     * @brief 规划器
-     * @param services 受到影响的业务编号 
-     * @param output 成功重新规划的业务编号（放入output的业务会自动被设置为复活）
-     */
-    virtual void Planning(const vector<uint16_t>& services, vector<uint16_t>& output) = 0;
-    void PrintAns(const vector<uint16_t>& service) const {
-        printf("%lu\n", service.size());
-        for (auto bid : service) {
-            const Service& ser = s.GetServiceConst(bid);
-            const vector<Step>& path = ser.GetPath();
-            printf("%u %lu\n", ser.GetId(), path.size());
-            for (auto step : path) {
-                printf("%u %u %u ", step.GetEdge(), step.GetStartChannel(), step.GetEndChannel());
-            }
-            printf("\n");
-        }
-        fflush(stdout);
-    }
-};
-
-/**
- * @brief 徐天泽的算法
- */
-class SolutionXTZ final : public Solution {
-public:
-    explicit SolutionXTZ(const Scene& s) : Solution(s) {}
-
-private:
-    /**
-     * @brief 业务比较函数
-     * @param s1 业务1
-     * @param s2 业务2
-     * @return true 在排序时将业务1放在前面
-     * @return false 在排序时将业务2放在前面
-     */
-    bool ServiceCompare(const Service& s1, const Service& s2) const override {
-        if (s1.GetValue() == s2.GetValue()) {
-            return s1.GetUseChannelsNum() < s2.GetUseChannelsNum();
-        }
-        return s1.GetValue() > s2.GetValue();
-    }
-    /**
-     * @brief 规划器
-     * @param services 受到影响的业务编号 
-     * @param output 成功重新规划的业务编号（放入output的业务会自动被设置为复活）
-     */
-    void PrintEdgeByService(Service service){
-        vector<Step> path = service.GetPath();
-        for(auto step : path){
-            Edge& e = s.GetEdge(step.GetEdge());
-            // printf("边%d的第%d个通道占用情况%d\n", e.GetId(), step.GetStartChannel(), e.GetChannel(step.GetStartChannel()));
-        }
-    }
-    /**
-     * @brief 规划器
-     * @param services 受到影响的业务编号 
-     * @param output 成功重新规划的业务编号（放入output的业务会自动被设置为复活）
-     */
-    void Planning(const vector<uint16_t>& services, vector<uint16_t>& output) override {
-<<<<<<< HEAD
-        for (auto b : services) {
-            s.HideServicePath(b);
-            const auto& service = s.GetService(b);
-            uint16_t start = service.GetStart();
-            uint16_t end = service.GetEnd();
-            // 这里编号是对的吗？ 编号都是从1开始的 数组会不会小了一个？
-            vector<bool> visited(s.GetNodesNum()+5, false);
-=======
-        // BFS(services, output);
-        AStar(services, output);
-    }
-    void BFS(const vector<uint16_t>& services, vector<uint16_t>& output) {
-        for (auto sid : services) {
-            s.HideServicePath(sid);
-            const auto& service = s.GetService(sid);
-            const uint16_t start = service.GetStart();
-            const uint16_t end = service.GetEnd();
->>>>>>> b6a6b03c7906fe98c01e28dc2016254dd369cff1
-            struct BfsNode {
-                uint16_t n; // 终点
-                uint8_t c; // 使用的通道
-                uint16_t e; // 抵达终点的边
-                BfsNode* f; // 父结点
-            };
-            queue<BfsNode*> openSet; // 开集，待遍历
-            queue<BfsNode*> closeSet; // 闭集，已完成遍历
-            BfsNode* endNode = nullptr;
-            for (uint8_t round = 0; round <= 1; ++round) {
-                vector<bool> visited(s.GetNodesNum(), false);
-                bool allowChangeChannel = bool(round); // 先不允许换通道，没有方案再换通道
-                // 推入搜索起点
-                openSet.push(new BfsNode{start, service.GetDefaultChannelStart(), INVALID_ID, nullptr});
-                while (!openSet.empty()) { // BFS
-                    auto node = openSet.front();
-                    openSet.pop();
-                    if (node->n == end) {
-                        endNode = node;
-                        closeSet.push(node);
-                        break;
-                    }
-                    visited[node->n - 1] = true;
-                    vector<uint16_t> edges = s.GetNodeConst(node->n).GetConnectedEdges();
-                    sort(edges.begin(), edges.end(), [=](uint16_t e1, uint16_t e2) {
-                        uint16_t n1 = s.GetEdge(e1).GetAnotherNode(node->n);
-                        uint16_t n2 = s.GetEdge(e2).GetAnotherNode(node->n);
-                        if (s.GetNodeDistance(n1, end) < s.GetNodeDistance(n2, end)) {
-                            return true;
-                        }
-                        return s.GetNodeConst(n1).GetRemainChangeChannelCnt() > s.GetNodeConst(n2).GetRemainChangeChannelCnt();
-                    });
-                    for (auto e : edges) { // 从连接的边中找另一端结点
-                        Edge& edge = s.GetEdge(e);
-                        if (!edge.IsAlive()) { // 断边不考虑
-                            continue;
-                        }
-                        uint16_t nextNode = edge.GetAnotherNode(node->n);
-                        if (visited[nextNode - 1]) { // 遍历过的点不考虑
-                            continue;
-                        }
-                        uint8_t nextChannel = node->c;
-                        // 如果通道被占用，特殊处理
-                        // !TODO:查询时间复杂度过高，需要优化
-                        if (!edge.CheckChannelsFree(nextChannel, service.GetUseChannelsNum())) {
-                            if (!allowChangeChannel || !s.GetNode(node->n).IsAllowChangeChannel()) {
-                                continue;
-                            }
-                            nextChannel = edge.AllocateChannel(service.GetUseChannelsNum());
-                            if (nextChannel == 0) { // 没找到能分配的通道
-                                continue;
-                            }
-                        }
-                        openSet.push(new BfsNode{nextNode, nextChannel, e, node});
-                    }
-                    closeSet.push(node);
-                } 
-                if (endNode) { // 找到了方案就不再尝试
-                    break;
-                }
-            }
-            if (endNode) {
-                vector<Step> path;
-                while (endNode->f != nullptr) {
-                    path.push_back(Step(endNode->e, endNode->f->n, endNode->c, service.GetUseChannelsNum(), endNode->f->f ? endNode->c != endNode->f->c : false));
-                    endNode = endNode->f;
-                }
-                s.ResetServicePath(sid, path, true);
-                output.push_back(sid);
-            }
-            while (!openSet.empty()) {
-                delete openSet.front();
-                openSet.pop();
-            }
-            while (!closeSet.empty()) {
-                delete closeSet.front();
-                closeSet.pop();
-            }
-            s.RecoverServicePath(sid, endNode == nullptr); // 恢复老路径，但不覆盖掉新路径
-        }
-        // 所有新路径至此已经生成完毕
-        s.ClearHidedPath(true); // 先不考虑新路径是否包含老路径，将老路径全部再删除一遍
-        for (auto sid : services) { // 将新路径更新到场景中
-            s.AddServicePath(sid);
-        }
-    }
-    void AStar(const vector<uint16_t>& services, vector<uint16_t>& output) {
-        constexpr double CHANGE_CHANNEL_COST = 0.1; // 换通道的成本
-        for (auto sid : services) {
-            s.HideServicePath(sid);
-            const auto& service = s.GetService(sid);
-            const uint16_t startNode = service.GetStart();
-            const uint16_t endNode = service.GetEnd();
-            const uint16_t useChannelsNum = service.GetUseChannelsNum();
-            struct AStarNode {
-                uint16_t n; // 终点结点
-                uint8_t c; // 使用的通道
-                uint16_t e; // 抵达终点的边
-                AStarNode* f; // 父结点
-                double passed; // 已走过的路的总成本
-                double remain; // 剩余距离
-                double Cost() const {return passed + remain;}
-                bool operator<(const AStarNode& rhs) const {return Cost() < rhs.Cost();}
-            };
-            uint8_t searchChannelsNum = Edge::CHANNELS_NUM - useChannelsNum + 1; // 可以作为起始通道的通道总数
-            // 已访问的起始通道 第一维为边的编号，第二维为起始通道编号（末尾的几个通道因为宽度不够，一定不会作为起始通道）
-            vector<vector<bool>> visited(s.GetEdgesNum(), vector<bool>(searchChannelsNum, false));
-            vector<bool> visitedEdge(s.GetEdgesNum(), false); // 边是否访问
-            // 根据已占用的通道信息，将不可能作为起始通道的通道标记为已访问
-            for (uint16_t eid = 1; eid <= s.GetEdgesNum(); ++eid) {
-                const Edge& edge = s.GetEdgeConst(eid);
-                if (!edge.IsAlive()) { // 将断边设置为已访问
-                    visitedEdge[eid - 1] = true;
-                    continue;
-                }
-                // 倒序遍历，当通道被占用，向前推 useChannelsNum 个通道都不可能作为起始通道
-                bool isLastChannelFree = searchChannelsNum == Edge::CHANNELS_NUM ?
-                    false : edge.CheckChannelsFree(searchChannelsNum + 1, useChannelsNum - 1); // 上一个通道是否未被占用
-                for (int8_t cid = searchChannelsNum; cid >= 1; --cid) { // 向下循环不能用无符号数，使用有符号的int8_t
-                    // 如果通道被占用，设置为已访问
-                    if (!edge.CheckChannelFree(cid)) {
-                        isLastChannelFree = false;
-                        visited[eid - 1][cid - 1] = true;
-                    // 通道没被占用，而上一个通道被占用，说明到了占用与未占用的分界处，向下推 useChannelsNum - 1 个通道都设置为已访问
-                    } else if (!isLastChannelFree) {
-                        isLastChannelFree = true;
-                        uint8_t banId = cid; // 需要禁用的通道
-                        for (uint8_t i = 0; i < useChannelsNum - 1; ++i) {
-                            // 遇到了下一个占用通道的边界
-                            if (!edge.CheckChannelFree(banId)) {
-                                break;
-                            }
-                            visited[eid - 1][banId-- - 1] = true;
-                            if (banId == 0) { // 防止在推的过程中推到边界
-                                break;
-                            }
-                        }
-                        cid = banId + 1;
-                    }
-                }
-            }
-            AStarNode* root = new AStarNode{startNode, service.GetDefaultChannelStart(), INVALID_ID, nullptr,
-                                            0.0, double(s.GetNodeDistance(startNode, endNode))};
-            AStarNode* current = root; // 正在遍历的结点
-            list<AStarNode*> openSet; // 开集，待遍历
-            queue<AStarNode*> closeSet; // 闭集，已完成遍历
-            bool isSuccess = false; // 已完成寻路
-            while (!isSuccess) {
-                const vector<uint16_t>& edges = s.GetNodeConst(current->n).GetConnectedEdges();
-                for (auto eid : edges) {
-                    if (!visitedEdge[eid - 1]) {
-                        visitedEdge[eid - 1] = true;
-                        const Edge& edge = s.GetEdgeConst(eid);
-                        const uint16_t nid = edge.GetAnotherNode(current->n);
-                        const Node& node = s.GetNodeConst(nid);
-                        uint16_t remainDis = s.GetNodeDistance(nid, endNode);
-                        if (remainDis == UINT16_MAX) {continue;}
-                        for (uint8_t cid = 1; cid < searchChannelsNum; ++cid) {
-                            if (!visited[eid - 1][cid - 1]) {
-                                visited[eid - 1][cid - 1] = true;
-                                double stepCost = 1.0; // 这一步的成本
-                                if (cid != current->c && node.IsAllowChangeChannel()) { // 增加换通道成本
-                                    stepCost += CHANGE_CHANNEL_COST;
-                                }
-                                auto newNode = new AStarNode{nid, cid, eid, current, current->passed + stepCost, double(remainDis)};
-                                // 将新结点插入有序的 openSet
-                                bool insterted = false;
-                                for (auto it = openSet.begin(); it != openSet.end(); ++it) { // 插入有序表
-                                    if (*newNode < **it) {
-                                        openSet.insert(it, newNode);
-                                        insterted = true;
-                                        break;
-                                    }
-                                }
-                                if (!insterted) {
-                                    openSet.push_back(newNode);
-                                }
-                            }
-                        }
-                    }
-                }
-                closeSet.push(current); // 将当前结点加入闭集
-                if (openSet.empty()) { // 开集为空，说明寻路失败
-                    break;
-                }
-                current = openSet.front(); // 取出代价最小的结点
-                openSet.pop_front();
-                if (current->n == endNode) { // 寻路结束
-                    vector<Step> path;
-                    for (; current->f != nullptr; current = current->f) {
-                        path.push_back(Step(current->e, current->f->n, current->c, useChannelsNum, current->f->f ? current->c != current->f->c : false));
-                    }
-                    s.ResetServicePath(sid, path, true);
-                    output.push_back(sid);
-                    isSuccess = true;
-                }
-            }
-            while (!openSet.empty()) {
-                delete openSet.front();
-                openSet.pop_front();
-            }
-            while (!closeSet.empty()) {
-                delete closeSet.front();
-                closeSet.pop();
-            }
-            s.RecoverServicePath(sid, !isSuccess); // 恢复老路径
-        }
-        // 所有新路径至此已经生成完毕
-        s.ClearHidedPath(true); // 先不考虑新路径是否包含老路径，将老路径全部再删除一遍
-        for (auto sid : services) { // 将新路径更新到场景中
-            s.AddServicePath(sid);
-        }
-    }
-};
-
-/**
- * @brief 唐鑫的算法
- */
-class SolutionTX final : public Solution {
-public:
-    explicit SolutionTX(const Scene& s) : Solution(s) {}
-
-private:
-<<<<<<< HEAD
-    class ProgramPlan{
-        private:
-            uint16_t businessId; // 业务Id
-            vector<Step> path; // 目前最优解
-            uint16_t score; // 分数
-        public:
-            ProgramPlan(uint16_t businessId) : businessId(businessId){}
-            ProgramPlan(uint16_t businessId, vector<Step> path, uint16_t score) : businessId(businessId), path(path), score(score){};
-            uint16_t GetScore(){return score;}
-            uint16_t GetBusinessId(){return businessId;}
-            vector<Step> GetPath(){return path;}
-            void SetScore(uint16_t score){this->score = score;}
-            void SetPath(vector<Step> path){this->path = path;}
-    };
-    queue<vector<Step>> q;
-    uint16_t n1,n2,n3; // 超参数
-
-
-    static bool scoreCmp(ProgramPlan a, ProgramPlan b){
-        return a.GetScore() > b.GetScore();
-=======
-    /**
-     * @brief 业务比较函数
-     * @param s1 业务1
-     * @param s2 业务2
-     * @return true 在排序时将业务1放在前面
-     * @return false 在排序时将业务2放在前面
-     */
-    bool ServiceCompare(const Service& s1, const Service& s2) const override {
-        return true;
-    }
-    /**
-     * @brief 规划器
-     * @param services 受到影响的业务编号 
-     * @param output 成功重新规划的业务编号（放入output的业务会自动被设置为复活）
-     */
-    void Planning(const vector<uint16_t>& services, vector<uint16_t>& output) override {
-        
->>>>>>> b6a6b03c7906fe98c01e28dc2016254dd369cff1
-    }
-        /**
-     * @brief 徐哥BFS的方法
-     * @param b 受到影响的业务编号 
-     * @param vector<Step> 成功重新规划的路径
-     */
-    vector<Step> BFSNew(uint16_t b){
-        
-        const auto& service = s.GetService(b);
-        uint16_t start = service.GetStart();
-        uint16_t end = service.GetEnd();
-        // 这里编号是对的吗？ 编号都是从1开始的 数组会不会小了一个？
-        vector<bool> visited(s.GetNodesNum()+5, false);
-        struct BfsNode {
-            uint16_t n; // 终点
-            uint16_t e; // 抵达终点的边
-            uint16_t startChannel; // 通道起点
-            bool isChange; // 是否变道
-            BfsNode* f; // 父结点
-        };
-        queue<BfsNode*> openSet; // 开集，待遍历
-        queue<BfsNode*> closeSet; // 闭集，已完成遍历
-        openSet.push(new BfsNode{start, INVALID_ID, INVALID_ID, false, nullptr});
-        BfsNode* endNode = nullptr;
-        vector<Step> path;
-        while (!openSet.empty()) { // BFS
-            auto node = openSet.front();
-            openSet.pop();
-            visited[node->n - 1] = true;
-            if (node->n == end) {
-                endNode = node;
-                closeSet.push(node);
-                break;
-            }
-            const vector<uint16_t>& edges = s.GetNodeConst(node->n).GetConnectedEdges();
-            for (auto e : edges) { // 从连接的边中找另一端结点
-                Edge& edge = s.GetEdge(e);
-                bool isChange = false;
-                uint16_t startChannel=-1;
-                bool isOk=false;
-                // 对变通道的考虑
-                if(edge.IsAlive()){
-                    //TODO 查找算法的优化 时间复杂度太大了
-                    if(edge.CheckChannelsFree(service.GetDefaultChannelStart(), service.GetDefualtChannelEnd())){
-                        startChannel = service.GetDefaultChannelStart();
-                        isOk = true;
-                    }else if(s.GetNode(node->n).GetRemainChangeChannelCnt()>0){
-                        //通过变道来解决问题
-                        // TODO 优化 找尽量少会影响到后面业务路径通道的区间
-                        isChange = true;
-                        isOk = true;
-                        uint16_t emptyBegin = edge.findEmptyChannel(service.GetUseChannelsNum());
-                        startChannel = emptyBegin;
-                    }
-                }
-                uint16_t nextNode = edge.GetAnotherNode(node->n);
-                if (!visited[nextNode - 1] && isOk) {
-                    openSet.push(new BfsNode{nextNode, e, startChannel, isChange, node});
-                }
-            }
-            closeSet.push(node);
-        }
-        if (endNode) {
-            while (endNode->f != nullptr) {
-                path.push_back(Step(endNode->e, endNode->f->n, endNode->startChannel, service.GetUseChannelsNum(), endNode->isChange));
-                endNode = endNode->f;
-            }
-        }
-        while (!openSet.empty()) {
-            delete openSet.front();
-            openSet.pop();
-        }
-        while (!closeSet.empty()) {
-            delete closeSet.front();
-            closeSet.pop();
-        }
-        if (!path.empty()) {
-            reverse(path.begin(), path.end());
-        }
-        return path;
-    }
-    // 判断业务能否塞入
-    bool PlanCheck(ProgramPlan plan){
-        // 有可能新规划的业务占用了已规划的通道
-    }
-    void Program(vector<ProgramPlan> &programPlans){
-        sort(programPlans.begin(), programPlans.end(), scoreCmp);
-        for(auto plan : programPlans){
-            // 判断能不能放进去 如果能放进去 有点冗余 因为已经判断过了 很冗余啊
-            uint16_t businessId = plan.GetBusinessId();
-            s.HideServicePath(businessId);
-            if(PlanCheck(plan)){
-                
-            }
-        }
-    }
-
-    // 对考虑变道情况的BFS进行测试
-    // 本算法为对service根据价值进行排序，考虑使用变道次数
-    void Planning(const vector<uint16_t>& services, vector<uint16_t>& output) override {
-        vector<ProgramPlan> unfinishPlans;
-        for(auto serviceId : services){
-            // 初始分数计算公式 = value
-            ProgramPlan plan(serviceId, vector<Step>(), s.GetService(serviceId).GetValue());
-            unfinishPlans.push_back(plan);
-        }
-        sort(unfinishPlans.begin(), unfinishPlans.end(), scoreCmp);
-        for(auto plan : unfinishPlans){
-            s.HideServicePath(plan.GetBusinessId());
-            vector<Step> path = BFSNew(plan.GetBusinessId());
-            if(!path.empty()){
-                s.ResetServicePath(plan.GetBusinessId(), path);
-                output.push_back(plan.GetBusinessId());
-                s.DeleteHidedPath(plan.GetBusinessId());
-            } else {
-                s.RecoverServicePath(plan.GetBusinessId());
-            }
-        }
-    }
-    // 循环优化（暂时未完成)
-    void CyclePlanningTest(const vector<uint16_t>& services, vector<uint16_t>& output) {
-        // 修改这里的结构 感觉可以直接直接用 programPlans 在这里初始化就行了 不要用uint16_t 太奇怪了
-        vector<ProgramPlan> unfinishPlans;
-        for(auto serviceId : services){
-            // 初始分数计算公式 = value
-            ProgramPlan plan(serviceId, vector<Step>(), s.GetService(serviceId).GetValue());
-            unfinishPlans.push_back(plan);
-        }
-        // 循环次数参数
-        int i = 0;
-        while(!unfinishPlans.empty() && i<20){
-            i++;
-            // 先查找路径 得到目前的最优解
-            sort(unfinishPlans.begin(), unfinishPlans.end(), scoreCmp);
-            for(auto it = unfinishPlans.begin(); it != unfinishPlans.end(); it++){
-                ProgramPlan plan = *it;
-                s.HideServicePath(plan.GetBusinessId());
-                Service& service = s.GetService(plan.GetBusinessId());
-                vector<Step> ProgramPath = BFSNew(service.GetId());
-                // TODO 根据上轮BFS的解来找次优解
-                if(!ProgramPath.empty()||plan.GetPath().empty()){
-                    // 规划成功 直接把业务塞进去
-                    s.ResetServicePath(plan.GetBusinessId(), ProgramPath);
-                    output.push_back(plan.GetBusinessId());
-                    s.DeleteHidedPath(plan.GetBusinessId());
-                    unfinishPlans.erase(it);
-                    continue;
-                    // 删除这个plan
-                }else{
-                    // 计算变道次数
-                    // 重新赋值 到下一次循环再说
-                    s.RecoverServicePath(plan.GetBusinessId());
-                    uint16_t changeNum = 0;
-                    for(auto step : ProgramPath){
-                        if(step.GetUseChannelsNum()){
-                            changeNum++;
-                    }
-                    }
-                    // 计算分数
-                    int score = n1 * service.GetValue() - n2 * ProgramPath.size() - n3 * changeNum;
-                    plan.SetScore(score);
-                    plan.SetPath(ProgramPath);
-                }
-            }
-        }
-    }
-
-};
-
-/**
- * @brief 陈嘉的算法
- */
-class SolutionCJ final : public Solution {
-public:
-    explicit SolutionCJ(const Scene& s) : Solution(s) {}
-
-private:
-    /**
-     * @brief 业务比较函数
-     * @param s1 业务1
-     * @param s2 业务2
-     * @return true 在排序时将业务1放在前面
-     * @return false 在排序时将业务2放在前面
-     */
-    bool ServiceCompare(const Service& s1, const Service& s2) const override {
-        return true;
-    }
-    /**
-     * @brief 规划器
-     * @param services 受到影响的业务编号 
-     * @param output 成功重新规划的业务编号（放入output的业务会自动被设置为复活）
-     */
-    void Planning(const vector<uint16_t>& services, vector<uint16_t>& output) override {
-        
-    }
-};
-
-/**
- * @brief 主函数
- * @param argc
- * @param argv
- * @return int
- */
-int main(int argc, char **argv) {
-    /* LOG初始化 */////////////////////////////////////////////////////////////////////////////////////////////////
-    LOG_INIT(argc > 1 ? argv[1] : "log/log.txt"); // 程序运行时第一个参数传递log输出位置
-    LOG_LINE();
-    LOG_INFO("编译时间[%s %s]\n", __DATE__, __TIME__)
-    LOG_LINE();
-
-    /* 变量定义 *//////////////////////////////////////////////////////////////////////////////////////////////////
-    Scene original; // 初始场景
-
-    /* 初始环境输入 *///////////////////////////////////////////////////////////////////////////////////////////////
-    int N, M;
-    scanf("%d %d", &N, &M);
-    for (int i = 0; i < N; ++i) {
-        int Pi;
-        scanf("%d", &Pi);
-        original.AddNode(Pi);
-    }
-    original.CreateNodeDistanceTable(N);
-    for (int i = 0; i < M; ++i) {
-        int ui, vi;
-        scanf("%d %d", &ui, &vi);
-        if (ui < vi) {
-            original.AddEdge(ui, vi);
-        } else {
-            original.AddEdge(vi, ui);
-        }
-    }
-    original.Floyd();
-    int J;
-    scanf("%d", &J);
-    for (int i = 0; i < J; ++i) {
-        int Src, Snk, S, L, R;
-        long V;
-        scanf("%d %d %d %d %d %ld", &Src, &Snk, &S, &L, &R, &V);
-        uint8_t useChannelsNum = R - L + 1;
-        original.AddService(Src, Snk, double(V), L, useChannelsNum);
-        for (int j = 0; j < S; ++j) {
-            int ei;
-            scanf("%d", &ei);
-            original.AddServiceStep(i + 1, ei);
-        }
-    }
-#ifdef DEBUG
-    double initValue = original.GetValue(); // 初始状态业务总价值
-    double finalScore = 0.0; // 最终得分
-#endif // DEBUG
-
-    /* 交互部分 *//////////////////////////////////////////////////////////////////////////////////////////////////
-    int T;
-    scanf("%d", &T);
-    for (int i = 0; i < T; ++i) {
-        LOG_INFO("场景[%3d]###########################################################################\n", i + 1);
-        //auto s{new SolutionXTZ(original)};
-        auto s{new SolutionTX(original)};
-        // auto s{new SolutionCJ(original)};
-        int e_failed;
-        while (true) {
-            scanf("%d", &e_failed);
-            if (e_failed == -1) {
-                break;
-            }
-            s->Handle(e_failed);
-        }
-#ifdef DEBUG
-        double score = s->GetValue() * 10000.0 / initValue; // 本场景得分
-        LOG_INFO("得分：%.0f\n", score);
-        finalScore += score;
-#endif // DEBUG
-        delete s;
-    }
-    original.DeleteNodeDistanceTable(); // 释放内存
-
-    /* LOG输出 *//////////////////////////////////////////////////////////////////////////////////////////////////
-    LOG_LINE();
-#ifdef DEBUG
-    LOG_INFO("总分：%.0f\n", finalScore);
-#endif // DEBUG
-
-    return 0;
+/**
+ * @file main.cpp
+ * @brief 2024华为嵌入式软件大赛·追光者(算法组)
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cassert>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <string>
+#include <list>
+#include <queue>
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <memory>
+#include <unordered_map>
+#include <chrono>
+#include <atomic>
+#include <future>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+/* LOG */
+#ifdef DEBUG // DEBUG在本地g++编译时定义，上传至官网后不会被定义
+    #define LOG_INIT(LOG_FILE_PATH) {freopen(LOG_FILE_PATH, "w+", stderr);}
+    #define LOG_INFO(arg...) {fprintf(stderr, ##arg); fflush(stderr);}
+    #define LOG_LINE() LOG_INFO("####################################################################################\n");
+    #define LOG(arg...) {fprintf(stderr, "%s:%d > ", __FILE__, __LINE__); fprintf(stderr, ##arg);}
+    #define ASSERT(state) assert(state)
+#else
+    #define LOG_INIT(...)
+    #define LOG_INFO(...)
+    #define LOG_LINE(...)
+    #define LOG(...)
+    #define ASSERT(...)
+#endif // DEBUG
+
+#define ASSERT_ID(id, vec) ASSERT(id > 0 && (id - 1) < vec.size())
+
+static constexpr uint16_t INVALID_ID = 0; // 无效ID
+
+/**
+ * @brief 有编号的类型
+ */
+class IdObject {
+public:
+    explicit IdObject(uint16_t id) : id(id) {}
+
+public:
+    uint16_t GetId() const {return id;}
+
+protected:
+    uint16_t id;
+};
+
+/**
+ * @brief 有存活状态的类型
+ */
+class LiveObject {
+public:
+    explicit LiveObject(bool isAlive = true) : isAlive(isAlive) {}
+
+public:
+    bool IsAlive() const {return isAlive;}
+    void SetAlive(bool isAlive = true) {this->isAlive = isAlive;}
+    void Kill() {SetAlive(false);}
+
+protected:
+    bool isAlive;
+};
+
+static constexpr size_t CHANNEL_MASK_WORDS = 2; // 通道位图的字数，最多支持 64 * CHANNEL_MASK_WORDS 个通道
+
+/**
+ * @brief 通道位图，第i位为1表示通道i+1空闲
+ */
+struct ChannelMask {
+    uint64_t words[CHANNEL_MASK_WORDS];
+
+    /**
+     * @brief 低n位为1的位图
+     */
+    static ChannelMask Low(size_t n) {
+        ChannelMask ret{};
+        for (size_t i = 0; i < CHANNEL_MASK_WORDS; ++i) {
+            ret.words[i] = LowWord(n, i);
+        }
+        return ret;
+    }
+    /**
+     * @brief 低n位为1的位图的第i个字
+     */
+    static constexpr uint64_t LowWord(size_t n, size_t i) {
+        return n >= 64 * (i + 1) ? ~0ULL : n <= 64 * i ? 0ULL : (1ULL << (n - 64 * i)) - 1;
+    }
+    bool Test(size_t bit) const {return (words[bit / 64] >> (bit % 64)) & 1;}
+    void Set(size_t bit) {words[bit / 64] |= 1ULL << (bit % 64);}
+    void Reset(size_t bit) {words[bit / 64] &= ~(1ULL << (bit % 64));}
+    bool Any() const {
+        for (auto word : words) {
+            if (word) {return true;}
+        }
+        return false;
+    }
+    /**
+     * @brief 最低的为1的位，调用前需保证Any()
+     */
+    size_t First() const {
+        size_t i = 0;
+        while (!words[i]) {++i;}
+        return i * 64 + __builtin_ctzll(words[i]);
+    }
+    /**
+     * @brief 最长的连续为1的位数，按连续段跳跃，复杂度与段数成正比
+     */
+    size_t LongestRun() const {
+        size_t longest = 0, run = 0;
+        for (auto word : words) {
+            size_t bits = 64; // 本字剩余的位数
+            while (bits > 0) {
+                if (word & 1) {
+                    const size_t ones = min<size_t>(~word ? __builtin_ctzll(~word) : 64, bits);
+                    run += ones;
+                    longest = max(longest, run);
+                    word = ones < 64 ? word >> ones : 0;
+                    bits -= ones;
+                } else if (word) {
+                    const size_t zeros = __builtin_ctzll(word);
+                    run = 0;
+                    word >>= zeros;
+                    bits -= zeros;
+                } else {
+                    run = 0;
+                    bits = 0;
+                }
+            }
+        }
+        return longest;
+    }
+};
+
+/**
+ * @brief 按通道宽度特化的通道查询内核，宽度为编译期常量，编译器可以完全展开窗口检查
+ * @tparam W 通道宽度
+ * @tparam WORDS 参与计算的位图字数，通道数不超过64时只用一个字
+ */
+template <size_t W, size_t WORDS>
+struct ChannelKernel {
+    static_assert(W <= 64 * WORDS && WORDS <= CHANNEL_MASK_WORDS, "channel width out of range");
+
+    /**
+     * @brief 位图右移n位（只处理前WORDS个字）
+     */
+    static ChannelMask ShiftRight(const ChannelMask& mask, size_t n) {
+        ChannelMask ret{};
+        const size_t wordShift = n / 64, bitShift = n % 64;
+        for (size_t i = 0; i + wordShift < WORDS; ++i) {
+            ret.words[i] = mask.words[i + wordShift] >> bitShift;
+            if (bitShift && i + wordShift + 1 < WORDS) {
+                ret.words[i] |= mask.words[i + wordShift + 1] << (64 - bitShift);
+            }
+        }
+        return ret;
+    }
+    /**
+     * @brief 检查从startChannel开始的W个通道是否都空闲
+     */
+    static bool CheckFree(const ChannelMask& freeMask, uint8_t startChannel) {
+        ChannelMask window = ShiftRight(freeMask, startChannel - 1);
+        for (size_t i = 0; i < WORDS; ++i) {
+            const uint64_t need = ChannelMask::LowWord(W, i);
+            if ((window.words[i] & need) != need) {
+                return false;
+            }
+        }
+        return true;
+    }
+    /**
+     * @brief 计算所有可以作为起始通道的通道
+     * @return ChannelMask 第i位为1表示从通道i+1开始的W个通道都空闲
+     */
+    static ChannelMask Starts(const ChannelMask& freeMask) {
+        ChannelMask starts{};
+        for (size_t i = 0; i < WORDS; ++i) {
+            starts.words[i] = freeMask.words[i];
+        }
+        if (W == 0) {
+            return starts;
+        }
+        // 倍增：len个连续空闲位的起点集合与其右移len位求与，得到2*len个连续空闲位的起点集合
+        size_t len = 1;
+        for (; len * 2 <= W; len *= 2) {
+            And(starts, ShiftRight(starts, len));
+        }
+        if (len < W) {
+            And(starts, ShiftRight(starts, W - len));
+        }
+        return starts;
+    }
+    /**
+     * @brief 首次适配：编号最小的可以作为起始通道的通道
+     * @return uint8_t 为0时代表无可用通道
+     */
+    static uint8_t Allocate(const ChannelMask& freeMask) {
+        ChannelMask starts = Starts(freeMask);
+        for (size_t i = 0; i < WORDS; ++i) {
+            if (starts.words[i]) {
+                return i * 64 + __builtin_ctzll(starts.words[i]) + 1;
+            }
+        }
+        return 0;
+    }
+
+private:
+    static void And(ChannelMask& lhs, const ChannelMask& rhs) {
+        for (size_t i = 0; i < WORDS; ++i) {
+            lhs.words[i] &= rhs.words[i];
+        }
+    }
+};
+
+/**
+ * @brief 通道查询内核表的一项
+ */
+struct ChannelKernelEntry {
+    bool (*checkFree)(const ChannelMask& freeMask, uint8_t startChannel);
+    ChannelMask (*starts)(const ChannelMask& freeMask);
+    uint8_t (*allocate)(const ChannelMask& freeMask);
+};
+
+/**
+ * @brief 生成以通道宽度为下标的内核表
+ */
+template <size_t WORDS, size_t... W>
+constexpr array<ChannelKernelEntry, sizeof...(W)> MakeChannelKernelTable(index_sequence<W...>) {
+    return {{{&ChannelKernel<W, WORDS>::CheckFree, &ChannelKernel<W, WORDS>::Starts,
+              &ChannelKernel<W, WORDS>::Allocate}...}};
+}
+
+/**
+ * @brief 边
+ */
+class Edge : public IdObject, public LiveObject {
+public:
+    static const uint8_t DEFAULT_CHANNELS_NUM = 40; // 默认通道数
+    static const uint8_t MAX_CHANNELS_NUM = 64 * CHANNEL_MASK_WORDS; // 支持的最大通道数
+
+public:
+    Edge(uint16_t id, uint16_t node1, uint16_t node2, uint8_t channelsNum = DEFAULT_CHANNELS_NUM) :
+        IdObject(id), node1(node1), node2(node2), channels(channelsNum, INVALID_ID),
+        freeMask(ChannelMask::Low(channelsNum)), kernels(SelectKernels(channelsNum)), version(NextVersion())
+    {
+        ASSERT(channelsNum <= MAX_CHANNELS_NUM);
+    }
+
+public:
+    /**
+     * @brief 获取另一个端点
+     * @param node 端点编号
+     * @return uint16_t 另一个端点的编号
+     */
+    uint16_t GetAnotherNode(uint16_t node) const {
+        ASSERT(node == node1 || node == node2);
+        return node == node1 ? node2 : node1;
+    }
+    uint16_t GetNode1() const {return node1;}
+    uint16_t GetNode2() const {return node2;}
+    uint8_t GetChannelsNum() const {return channels.size();}
+    uint16_t GetChannel(uint8_t id) const {ASSERT_ID(id, channels); return channels[id - 1];}
+    /**
+     * @brief 通道占用版本号，每次修改通道占用时取一个全局递增的新值，版本号相同说明占用情况相同（跨场景也成立）
+     */
+    uint32_t GetVersion() const {return version;}
+    /**
+     * @brief 最长的连续空闲通道数，按版本号缓存，通道占用变化后第一次查询时重新计算
+     */
+    uint8_t GetMaxFreeRun() const {
+        if (maxFreeRunVersion != version) {
+            maxFreeRunVersion = version;
+            maxFreeRun = freeMask.LongestRun();
+        }
+        return maxFreeRun;
+    }
+    void SetChannel(uint8_t id, uint16_t service) {
+        ASSERT_ID(id, channels); 
+#ifdef DEBUG
+        if(GetChannel(id) != INVALID_ID && service != INVALID_ID && GetChannel(id) != service) {
+            LOG("[Warning] Edge[%02d](%02d): [%02d]->[%02d] Channel is not released before use!\n",
+                GetId(), id, GetChannel(id), service);
+        }
+#endif // DEBUG
+        channels[id - 1] = service;
+        if (service == INVALID_ID) {
+            freeMask.Set(id - 1);
+        } else {
+            freeMask.Reset(id - 1);
+        }
+        version = NextVersion();
+    }
+    void SetChannels(uint8_t startChannel, uint8_t useChannelsNum, uint16_t service) {
+        for (uint8_t i = 0; i < useChannelsNum; ++i) {
+            SetChannel(startChannel++, service);
+        }
+    }
+    bool CheckChannelFree(uint8_t channel) const {ASSERT_ID(channel, channels); return freeMask.Test(channel - 1);}
+    bool CheckChannelsFree(uint8_t startChannel, uint8_t useChannelsNum) const {
+        ASSERT(startChannel + useChannelsNum - 1 <= GetChannelsNum());
+        return Kernel(useChannelsNum).checkFree(freeMask, startChannel);
+    }
+    /**
+     * @brief 获取所有可以作为起始通道的通道
+     * @param useChannelsNum 需要占用的通道数
+     * @return ChannelMask 第i位为1表示从通道i+1开始的useChannelsNum个通道都空闲
+     */
+    ChannelMask GetStartChannels(uint8_t useChannelsNum) const {
+        ASSERT(useChannelsNum <= GetChannelsNum());
+        return Kernel(useChannelsNum).starts(freeMask);
+    }
+    
+    /**
+     * @brief 查找空闲空间
+     * @param size 宽度
+     * @param busissnessId 业务Id 可以使用业务自身的资源
+     * @return 空区间的起点
+     */
+    uint16_t findEmptyChannel(int size){
+        uint16_t emptyBegin;
+        for(int i = 0; i < GetChannelsNum(); i++){
+            if(channels[i] == 0){
+                int flag = 1;
+                int j;
+                for(int j = 1; j < size; j++){
+                    if(i+j < GetChannelsNum() && channels[i+j] != 0){
+                        flag = 0;
+                        break;
+                    }
+                }
+                if(flag){
+                    emptyBegin = i;
+                    break;
+                }else{
+                    i = i+j;
+                }
+            }
+        }
+        // 通道编号是从1开始的 数组编号从0开始的
+        emptyBegin++;
+        return emptyBegin;
+    }
+    /**
+     * @brief 分配通道
+     * @param useChannelsNum 需要占用的通道数
+     * @return uint8_t 为0时代表无可用通道
+     */
+    uint8_t AllocateChannel(uint8_t useChannelsNum) {
+        // 采用首次适配法，取编号最小的可用起始通道
+        ASSERT(useChannelsNum <= GetChannelsNum());
+        return Kernel(useChannelsNum).allocate(freeMask);
+    }
+
+private:
+    /**
+     * @brief 选择通道查询内核表，通道数不超过64时使用单字内核
+     */
+    static const ChannelKernelEntry* SelectKernels(uint8_t channelsNum) {
+        static constexpr auto KERNELS_1 = MakeChannelKernelTable<1>(make_index_sequence<64 + 1>());
+        static constexpr auto KERNELS_N =
+            MakeChannelKernelTable<CHANNEL_MASK_WORDS>(make_index_sequence<MAX_CHANNELS_NUM + 1>());
+        return channelsNum <= 64 ? KERNELS_1.data() : KERNELS_N.data();
+    }
+    /**
+     * @brief 获取指定宽度的通道查询内核
+     */
+    const ChannelKernelEntry& Kernel(uint8_t useChannelsNum) const {
+        ASSERT(useChannelsNum <= GetChannelsNum());
+        return kernels[useChannelsNum];
+    }
+    static uint32_t NextVersion() {
+        static atomic<uint32_t> version{0}; // 组合规划器中多个策略并发修改各自的场景副本
+        return ++version;
+    }
+
+private:
+    uint16_t node1; // 编号数值较低的端点
+    uint16_t node2; // 编号数值较高的端点
+    vector<uint16_t> channels; // 占用各个通道的业务编号
+    ChannelMask freeMask; // 通道空闲位图，第i位为1表示通道i+1空闲
+    const ChannelKernelEntry* kernels; // 以通道宽度为下标的通道查询内核表
+    uint32_t version; // 通道占用版本号
+    mutable uint32_t maxFreeRunVersion = 0; // maxFreeRun对应的版本号
+    mutable uint8_t maxFreeRun = 0; // 最长的连续空闲通道数
+};
+
+/**
+ * @brief 结点
+ */
+class Node : public IdObject {
+public:
+    Node(uint16_t id, uint8_t changeChannelCntMax) :
+        IdObject(id), changeChannelCntMax(changeChannelCntMax), changeChannelCnt(0) {}
+
+public:
+    const vector<uint16_t>& GetConnectedEdges() const {return connectedEdges;}
+    uint8_t GetChangeChannelCntMax() const {return changeChannelCntMax;}
+    uint8_t GetRemainChangeChannelCnt() const {return changeChannelCntMax - changeChannelCnt;}
+    uint8_t GetChangeChannelCnt() const {return changeChannelCnt;}
+    void SetChangeChannelCnt(uint8_t cnt) {ASSERT(cnt <= changeChannelCntMax); changeChannelCnt = cnt;}
+    void AddEdge(uint16_t id) {connectedEdges.push_back(id);}
+    bool IsAllowChangeChannel() const {return GetRemainChangeChannelCnt() > 0;}
+    void UseChangeChannelCnt() {
+        if (changeChannelCnt < changeChannelCntMax) {
+            ++changeChannelCnt;
+        }
+    }
+    void ReleaseChangeChannelCnt() {
+        if (changeChannelCnt > 0) {
+            --changeChannelCnt;
+        }
+    }
+
+private:
+    vector<uint16_t> connectedEdges;
+    uint8_t changeChannelCntMax; // 最多可变通道数
+    uint8_t changeChannelCnt; // 可变通道数
+};
+
+/**
+ * @brief 路径上的一步
+ */
+class Step {
+public:
+    Step(uint16_t edge, uint16_t startNode, uint8_t startChannel, uint8_t useChannelsNum,
+         bool channelChanged = false) :
+        edge(edge), startNode(startNode), startChannel(startChannel),
+        useChannelsNum(useChannelsNum), channelChanged(channelChanged)
+    {
+        ASSERT(GetEndChannel() <= Edge::MAX_CHANNELS_NUM);
+    }
+
+public:
+    uint16_t GetEdge() const {return edge;}
+    uint16_t GetStartNode() const {return startNode;}
+    uint8_t GetStartChannel() const {return startChannel;}
+    uint8_t GetUseChannelsNum() const {return useChannelsNum;}
+    uint8_t GetEndChannel() const {return GetStartChannel() + GetUseChannelsNum() - 1;}
+    bool IsChannelChanged() const {return channelChanged;}
+
+private:
+    uint16_t edge;
+    uint16_t startNode;
+    uint8_t startChannel;
+    uint8_t useChannelsNum;
+    bool channelChanged; // 从起点处变更了通道
+};
+
+/**
+ * @brief 业务
+ */
+class Service : public IdObject, public LiveObject {
+public:
+    Service(uint16_t id, uint16_t start, uint16_t end, double value,
+            uint8_t defaultChannelStart, uint8_t useChannelsNum) :
+        IdObject(id), start(start), end(end), pathEnd(start), value(value),
+        defaultChannelStart(defaultChannelStart), useChannelsNum(useChannelsNum),
+        lastChannelStart(defaultChannelStart) {}
+    void AddStep(uint16_t edge, uint16_t endNode, uint8_t startChannel) {
+        path.push_back(Step(edge, pathEnd, startChannel, GetUseChannelsNum(), lastChannelStart != startChannel));
+        pathEnd = endNode;
+        lastChannelStart = startChannel;
+    }
+    void AddStep(uint16_t edge, uint16_t endNode) {
+        AddStep(edge, endNode, GetLastChannelStart());
+    }
+    double GetValue() const {return value;}
+    uint16_t GetStart() const {return start;}
+    uint16_t GetEnd() const {return end;}
+    uint8_t GetDefaultChannelStart() const {return defaultChannelStart;}
+    uint8_t GetLastChannelStart() const {return lastChannelStart;}
+    uint8_t GetUseChannelsNum() const {return useChannelsNum;}
+    uint16_t GetDefualtChannelEnd() const {return defaultChannelStart + useChannelsNum - 1;}
+    const vector<Step>& GetPath() const {return path;}
+    vector<Step> ClearPath() {
+        auto ret = path;
+        path.clear();
+        pathEnd = start;
+        lastChannelStart = defaultChannelStart;
+        return ret;
+    }
+    /**
+     * @brief 重设路径（默认为完整有效路径，不进行检查）
+     * @param path 新路径
+     */
+    void ResetPath(const vector<Step>& path) {
+        this->path = path;
+        pathEnd = end;
+        lastChannelStart = path.back().GetStartChannel();
+    }
+    bool IsPathComplete() const {return pathEnd == end;}
+    /**
+     * @brief 获取路径当前已规划到的点
+     * @return uint16_t 路径当前已规划到的点
+     */
+    uint16_t GetPathEnd() const {return pathEnd;}
+
+private:
+    uint16_t start;
+    uint16_t end;
+    vector<Step> path;
+    uint16_t pathEnd; // 路径已经规划到的点
+    double value;
+    uint8_t defaultChannelStart;
+    uint8_t useChannelsNum;
+    uint8_t lastChannelStart; // 上次添加的路径中通道的起点
+};
+
+/**
+ * @brief 按字计算64位FNV-1a散列
+ * @param words 字序列
+ * @param wordsNum 字数
+ * @param hash 初始散列值，用于分段计算
+ */
+static uint64_t HashWords(const uint32_t* words, size_t wordsNum, uint64_t hash = 14695981039346656037ull) {
+    for (size_t i = 0; i < wordsNum; ++i) {
+        hash = (hash ^ words[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief 跳数距离的2-hop标签索引（剪枝地标标注）
+ * @note 按度数从大到小依次从每个结点出发做BFS，已有标签能给出不超过当前距离的结点被剪枝，
+ *       否则把(出发结点, 距离)加入该结点的标签；两点距离为两者标签中公共中枢的距离之和的最小值，
+ *       标签按中枢排名有序，查询为一次归并，内存与标签总数成正比
+ */
+class HubLabels {
+public:
+    HubLabels() = default;
+    HubLabels(const HubLabels&) = delete;
+    HubLabels& operator=(const HubLabels&) = delete;
+    ~HubLabels() {
+        if (mapping != nullptr) {
+            munmap(mapping, mappingSize);
+        }
+    }
+
+public:
+    /**
+     * @brief 构建索引
+     * @param adjacency 邻接表，下标为结点编号减一
+     */
+    void Build(const vector<vector<uint16_t>>& adjacency) {
+        const size_t nodesNum = adjacency.size();
+        vector<uint16_t> order(nodesNum); // 按度数从大到小排序的结点编号
+        for (size_t i = 0; i < nodesNum; ++i) {
+            order[i] = i + 1;
+        }
+        stable_sort(order.begin(), order.end(), [&] (uint16_t n1, uint16_t n2) {
+            return adjacency[n1 - 1].size() > adjacency[n2 - 1].size();
+        });
+        vector<vector<Entry>> labels(nodesNum);
+        vector<uint16_t> hubDistance(nodesNum, UINT16_MAX); // 出发结点到其标签中各中枢的距离，下标为中枢排名
+        vector<uint16_t> distance(nodesNum, UINT16_MAX); // 本轮BFS中各结点的距离
+        vector<uint16_t> visited; // 本轮BFS访问过的结点，兼作队列
+        for (uint16_t rank = 0; rank < nodesNum; ++rank) {
+            const uint16_t root = order[rank];
+            for (const auto& entry : labels[root - 1]) {
+                hubDistance[entry.hub] = entry.distance;
+            }
+            visited.assign(1, root);
+            distance[root - 1] = 0;
+            for (size_t i = 0; i < visited.size(); ++i) {
+                const uint16_t node = visited[i];
+                const uint16_t d = distance[node - 1];
+                bool isPruned = false;
+                for (const auto& entry : labels[node - 1]) {
+                    if (hubDistance[entry.hub] != UINT16_MAX && hubDistance[entry.hub] + entry.distance <= d) {
+                        isPruned = true;
+                        break;
+                    }
+                }
+                if (isPruned) {
+                    continue;
+                }
+                labels[node - 1].push_back(Entry{rank, d});
+                for (auto next : adjacency[node - 1]) {
+                    if (distance[next - 1] == UINT16_MAX) {
+                        distance[next - 1] = d + 1;
+                        visited.push_back(next);
+                    }
+                }
+            }
+            for (auto node : visited) {
+                distance[node - 1] = UINT16_MAX;
+            }
+            for (const auto& entry : labels[root - 1]) {
+                hubDistance[entry.hub] = UINT16_MAX;
+            }
+        }
+        // 所有标签连续存放
+        offsets.assign(1, 0);
+        entries.clear();
+        for (const auto& label : labels) {
+            entries.insert(entries.end(), label.begin(), label.end());
+            offsets.push_back(entries.size());
+        }
+        offsetsView = offsets.data();
+        entriesView = entries.data();
+        entriesNum = entries.size();
+    }
+    /**
+     * @brief 把索引追加到镜像字序列：标签数、各结点的标签起点（结点数加一个）、标签（每个标签一个字）
+     * @param words 镜像字序列
+     */
+    void Save(vector<uint32_t>& words) const {
+        ASSERT(offsetsView == offsets.data()); // 只有构建出的索引需要保存
+        words.push_back(entriesNum);
+        words.insert(words.end(), offsets.begin(), offsets.end());
+        const size_t begin = words.size();
+        words.resize(begin + entriesNum);
+        memcpy(words.data() + begin, entries.data(), entriesNum * sizeof(Entry));
+    }
+    /**
+     * @brief 直接使用内存映射的镜像中的索引（只读），析构时解除映射
+     * @param words 镜像中Save写入的位置
+     * @param nodesNum 结点数
+     * @param mapping 镜像的映射地址，由索引接管
+     * @param mappingSize 镜像的映射大小
+     * @return const uint32_t* 索引之后的位置
+     */
+    const uint32_t* Attach(const uint32_t* words, size_t nodesNum, void* mapping, size_t mappingSize) {
+        ASSERT(this->mapping == nullptr && offsets.empty());
+        entriesNum = words[0];
+        offsetsView = words + 1;
+        entriesView = reinterpret_cast<const Entry*>(offsetsView + nodesNum + 1);
+        this->mapping = mapping;
+        this->mappingSize = mappingSize;
+        return offsetsView + nodesNum + 1 + entriesNum;
+    }
+    /**
+     * @brief 查询两点的跳数距离
+     * @return uint16_t 不连通时为UINT16_MAX
+     */
+    uint16_t Query(uint16_t node1, uint16_t node2) const {
+        if (node1 == node2) {
+            return 0;
+        }
+        const Entry* it1 = entriesView + offsetsView[node1 - 1];
+        const Entry* end1 = entriesView + offsetsView[node1];
+        const Entry* it2 = entriesView + offsetsView[node2 - 1];
+        const Entry* end2 = entriesView + offsetsView[node2];
+        uint32_t distance = UINT16_MAX;
+        while (it1 != end1 && it2 != end2) {
+            if (it1->hub < it2->hub) {
+                ++it1;
+            } else if (it1->hub > it2->hub) {
+                ++it2;
+            } else {
+                distance = min<uint32_t>(distance, it1->distance + it2->distance);
+                ++it1;
+                ++it2;
+            }
+        }
+        return distance;
+    }
+    size_t GetEntriesNum() const {return entriesNum;}
+
+private:
+    struct Entry {
+        uint16_t hub; // 中枢的排名
+        uint16_t distance; // 到中枢的距离
+    };
+    static_assert(sizeof(Entry) == sizeof(uint32_t), "镜像中每个标签占一个字");
+
+private:
+    vector<uint32_t> offsets; // 各结点的标签在entries中的起点，长度为结点数加一
+    vector<Entry> entries; // 所有结点的标签
+    const uint32_t* offsetsView = nullptr; // 查询使用的标签起点，指向offsets或映射的镜像
+    const Entry* entriesView = nullptr; // 查询使用的标签，指向entries或映射的镜像
+    size_t entriesNum = 0; // 标签数
+    void* mapping = nullptr; // 映射的镜像，为空时使用自己构建的标签
+    size_t mappingSize = 0; // 映射的镜像大小
+};
+
+/**
+ * @brief 场景
+ */
+class Scene {
+public:
+    static constexpr uint16_t REGION_NODES_NUM = 32; // 划分区域时每个区域的目标结点数
+    static constexpr uint16_t CORRIDOR_SLACK = 2; // 走廊允许比两点最短距离多走的步数
+    static constexpr uint32_t IMAGE_MAGIC = 0x43534348; // 场景镜像文件头"HCSC"
+    static constexpr uint32_t IMAGE_VERSION = 1; // 场景镜像格式版本
+    static constexpr size_t IMAGE_HEADER_WORDS_NUM = 8; // 场景镜像文件头字数
+
+public:
+    explicit Scene(uint8_t channelsNum = Edge::DEFAULT_CHANNELS_NUM) : channelsNum(channelsNum) {
+        ASSERT(channelsNum > 0 && channelsNum <= Edge::MAX_CHANNELS_NUM);
+    }
+
+public:
+    void AddNode(uint8_t changeChannelCntMax) {nodes.push_back(Node(nodes.size() + 1, changeChannelCntMax));}
+    /**
+     * @brief 构建跳数距离索引（需要在所有边添加完成后调用），索引在所有场景间共享
+     */
+    void CreateDistanceIndex() {
+        ASSERT(distanceIndex == nullptr); // 只允许创建一次
+        distanceIndex = new HubLabels;
+        distanceIndex->Build(GetAdjacency());
+    }
+    void DeleteDistanceIndex() {
+        ASSERT(distanceIndex); // 只允许在创建后调用
+        delete distanceIndex;
+    }
+    /**
+     * @brief 获取初始拓扑上两点之间的跳数距离
+     * @return uint16_t 不连通时为UINT16_MAX
+     */
+    uint16_t GetNodeDistance(uint16_t node1, uint16_t node2) const {
+        ASSERT(distanceIndex);
+        ASSERT_ID(node1, nodes);
+        ASSERT_ID(node2, nodes);
+        return distanceIndex->Query(node1, node2);
+    }
+    size_t GetDistanceIndexSize() const {ASSERT(distanceIndex); return distanceIndex->GetEntriesNum();}
+    /**
+     * @brief 划分区域（需要在所有边添加完成后调用）：按BFS跳数做最远点采样选出区域中心，每个结点归入最近中心的区域；
+     *        与其他区域有边相连的结点为边界结点，区域之间的边界距离为两区域边界结点之间的最短距离
+     * @param regionNodesNum 每个区域的目标结点数
+     */
+    void CreatePartition(uint16_t regionNodesNum) {
+        ASSERT(partition == nullptr); // 只允许创建一次
+        partition = new Partition;
+        const uint16_t regionsNum = max<size_t>(1, (GetNodesNum() + regionNodesNum - 1) / regionNodesNum);
+        vector<uint16_t> centers{1};
+        vector<uint16_t> centerDistance = Bfs(centers); // 各结点到最近中心的距离
+        partition->regions.assign(GetNodesNum(), 0);
+        while (centers.size() < regionsNum) {
+            uint16_t farthest = 1;
+            for (uint16_t nid = 2; nid <= GetNodesNum(); ++nid) {
+                if (centerDistance[nid - 1] > centerDistance[farthest - 1]) {
+                    farthest = nid;
+                }
+            }
+            if (centerDistance[farthest - 1] == 0) { // 结点数少于区域数
+                break;
+            }
+            const vector<uint16_t> distance = Bfs({farthest});
+            for (uint16_t nid = 1; nid <= GetNodesNum(); ++nid) {
+                if (distance[nid - 1] < centerDistance[nid - 1]) {
+                    centerDistance[nid - 1] = distance[nid - 1];
+                    partition->regions[nid - 1] = centers.size();
+                }
+            }
+            centers.push_back(farthest);
+        }
+        partition->borderNodes.resize(centers.size());
+        for (uint16_t nid = 1; nid <= GetNodesNum(); ++nid) {
+            for (auto eid : GetNodeConst(nid).GetConnectedEdges()) {
+                if (GetRegion(GetEdgeConst(eid).GetAnotherNode(nid)) != GetRegion(nid)) {
+                    partition->borderNodes[GetRegion(nid)].push_back(nid);
+                    break;
+                }
+            }
+        }
+        // 从一个区域的所有边界结点同时出发做BFS，得到到其他区域边界结点的最短距离
+        partition->regionDistance.assign(centers.size(), vector<uint16_t>(centers.size(), UINT16_MAX));
+        for (uint16_t r1 = 0; r1 < centers.size(); ++r1) {
+            partition->regionDistance[r1][r1] = 0;
+            const vector<uint16_t> distance = Bfs(partition->borderNodes[r1]);
+            for (uint16_t r2 = 0; r2 < centers.size(); ++r2) {
+                for (auto border : partition->borderNodes[r2]) {
+                    if (r2 != r1) {
+                        partition->regionDistance[r1][r2] = min(partition->regionDistance[r1][r2], distance[border - 1]);
+                    }
+                }
+            }
+        }
+    }
+    void DeletePartition() {
+        ASSERT(partition); // 只允许在创建后调用
+        delete partition;
+    }
+    uint16_t GetRegionsNum() const {ASSERT(partition); return partition->borderNodes.size();}
+    uint16_t GetRegion(uint16_t node) const {ASSERT(partition); ASSERT_ID(node, nodes); return partition->regions[node - 1];}
+    uint16_t GetRegionDistance(uint16_t region1, uint16_t region2) const {
+        ASSERT(partition);
+        return partition->regionDistance[region1][region2];
+    }
+    /**
+     * @brief 获取两点之间的走廊：经过该区域的最短路径不超过两点距离加CORRIDOR_SLACK的区域，
+     *        先用区域间的边界距离排除明显绕远的区域，再用两点到区域边界结点的距离精确判断
+     * @param node1 起点
+     * @param node2 终点
+     * @param corridor 各区域是否在走廊中
+     * @return true 走廊不包含所有区域，可以用来限制搜索范围
+     * @return false 走廊包含所有区域
+     */
+    bool GetCorridor(uint16_t node1, uint16_t node2, vector<bool>& corridor) const {
+        const uint16_t region1 = GetRegion(node1), region2 = GetRegion(node2);
+        const uint16_t distance = GetNodeDistance(node1, node2);
+        if (distance == UINT16_MAX) {
+            return false;
+        }
+        const uint16_t maxDistance = distance + CORRIDOR_SLACK;
+        corridor.assign(GetRegionsNum(), false);
+        bool isRestricted = false;
+        for (uint16_t r = 0; r < GetRegionsNum(); ++r) {
+            corridor[r] = r == region1 || r == region2;
+            const uint16_t dis1 = GetRegionDistance(region1, r), dis2 = GetRegionDistance(r, region2);
+            if (!corridor[r] && dis1 != UINT16_MAX && dis2 != UINT16_MAX && dis1 + dis2 <= maxDistance) {
+                for (auto border : partition->borderNodes[r]) {
+                    if (GetNodeDistance(node1, border) + GetNodeDistance(border, node2) <= maxDistance) {
+                        corridor[r] = true;
+                        break;
+                    }
+                }
+            }
+            isRestricted |= !corridor[r];
+        }
+        return isRestricted;
+    }
+    /**
+     * @brief 把完整初始化的场景（含距离索引与区域划分）保存为二进制镜像
+     * @note 镜像为uint32_t字序列：文件头(MAGIC, VERSION, 数据字数, 0, 输入散列低/高位, 数据散列低/高位)之后依次为
+     *       通道数、结点数、边数、业务数，各结点(最多可变通道数, 已用次数)，各边(端点1, 端点2)，各边各通道的占用业务，
+     *       各业务(起点, 终点, 价值低/高位, 默认起始通道, 通道数, 是否存活, 路径长度, (边, 起始通道)...)，
+     *       区域划分(区域数, 各结点区域, 边界结点起点, 边界结点, 区域距离)，最后为距离索引（加载时直接映射使用）
+     * @param path 镜像文件
+     * @param inputHash 生成场景的输入的散列值，加载时用于判断镜像是否过期
+     * @return true 成功
+     */
+    bool SaveImage(const char* path, uint64_t inputHash) const {
+        ASSERT(distanceIndex && partition);
+        vector<uint32_t> words(IMAGE_HEADER_WORDS_NUM);
+        words.insert(words.end(), {channelsNum, uint32_t(GetNodesNum()), uint32_t(GetEdgesNum()), uint32_t(GetServicesNum())});
+        for (const auto& node : nodes) {
+            words.push_back(node.GetChangeChannelCntMax());
+            words.push_back(node.GetChangeChannelCntMax() - node.GetRemainChangeChannelCnt());
+        }
+        for (const auto& edge : edges) {
+            words.push_back(edge.GetNode1());
+            words.push_back(edge.GetNode2());
+        }
+        for (const auto& edge : edges) {
+            for (uint8_t c = 1; c <= channelsNum; ++c) {
+                words.push_back(edge.GetChannel(c));
+            }
+        }
+        for (const auto& service : services) {
+            uint64_t value;
+            const double v = service.GetValue();
+            memcpy(&value, &v, sizeof(value));
+            words.insert(words.end(), {service.GetStart(), service.GetEnd(), uint32_t(value), uint32_t(value >> 32),
+                                       service.GetDefaultChannelStart(), service.GetUseChannelsNum(),
+                                       service.IsAlive(), uint32_t(service.GetPath().size())});
+            for (const auto& step : service.GetPath()) {
+                words.push_back(step.GetEdge());
+                words.push_back(step.GetStartChannel());
+            }
+        }
+        words.push_back(GetRegionsNum());
+        words.insert(words.end(), partition->regions.begin(), partition->regions.end());
+        uint32_t borderOffset = 0;
+        for (const auto& borders : partition->borderNodes) {
+            words.push_back(borderOffset);
+            borderOffset += borders.size();
+        }
+        words.push_back(borderOffset);
+        for (const auto& borders : partition->borderNodes) {
+            words.insert(words.end(), borders.begin(), borders.end());
+        }
+        for (const auto& distance : partition->regionDistance) {
+            words.insert(words.end(), distance.begin(), distance.end());
+        }
+        distanceIndex->Save(words);
+        const size_t payloadWordsNum = words.size() - IMAGE_HEADER_WORDS_NUM;
+        const uint64_t checksum = HashWords(words.data() + IMAGE_HEADER_WORDS_NUM, payloadWordsNum);
+        const uint32_t header[IMAGE_HEADER_WORDS_NUM] = {IMAGE_MAGIC, IMAGE_VERSION, uint32_t(payloadWordsNum), 0,
+            uint32_t(inputHash), uint32_t(inputHash >> 32), uint32_t(checksum), uint32_t(checksum >> 32)};
+        copy(header, header + IMAGE_HEADER_WORDS_NUM, words.begin());
+        // 先写到同目录的临时文件再重命名覆盖：其他进程映射的旧镜像不会被改写，写入中途失败也不会留下不完整的镜像
+        const string tempPath = string(path) + ".tmp." + to_string(getpid());
+        FILE* file = fopen(tempPath.c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        bool ok = fwrite(words.data(), sizeof(uint32_t), words.size(), file) == words.size();
+        ok = fflush(file) == 0 && fsync(fileno(file)) == 0 && ok;
+        ok = fclose(file) == 0 && ok;
+        if (!ok || rename(tempPath.c_str(), path) != 0) {
+            remove(tempPath.c_str());
+            return false;
+        }
+        return true;
+    }
+    /**
+     * @brief 从二进制镜像加载场景（只能在空场景上调用），距离索引直接使用映射的镜像
+     * @param path 镜像文件
+     * @param inputHash 当前输入的散列值
+     * @return false 镜像不存在、版本或散列不符、数据损坏，此时场景保持为空
+     */
+    bool LoadImage(const char* path, uint64_t inputHash) {
+        ASSERT(nodes.empty() && distanceIndex == nullptr && partition == nullptr);
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || size_t(st.st_size) < IMAGE_HEADER_WORDS_NUM * sizeof(uint32_t)) {
+            close(fd);
+            return false;
+        }
+        const size_t size = st.st_size;
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+        const uint32_t* words = static_cast<const uint32_t*>(mapping);
+        const uint32_t* cur = words + IMAGE_HEADER_WORDS_NUM;
+        const size_t payloadWordsNum = words[2];
+        if (words[0] != IMAGE_MAGIC || words[1] != IMAGE_VERSION ||
+            (IMAGE_HEADER_WORDS_NUM + payloadWordsNum) * sizeof(uint32_t) != size ||
+            (uint64_t(words[5]) << 32 | words[4]) != inputHash ||
+            (uint64_t(words[7]) << 32 | words[6]) != HashWords(cur, payloadWordsNum) ||
+            cur[0] != channelsNum) {
+            munmap(mapping, size);
+            return false;
+        }
+        // 数据散列已校验，以下按保存时的格式读取
+        const uint32_t nodesNum = cur[1], edgesNum = cur[2], servicesNum = cur[3];
+        cur += 4;
+        nodes.reserve(nodesNum);
+        edges.reserve(edgesNum);
+        services.reserve(servicesNum);
+        for (uint32_t i = 0; i < nodesNum; ++i, cur += 2) {
+            AddNode(cur[0]);
+            for (uint32_t j = 0; j < cur[1]; ++j) {
+                nodes.back().UseChangeChannelCnt();
+            }
+        }
+        for (uint32_t i = 0; i < edgesNum; ++i, cur += 2) {
+            AddEdge(cur[0], cur[1]);
+        }
+        for (auto& edge : edges) {
+            for (uint8_t c = 1; c <= channelsNum; ++c, ++cur) {
+                if (*cur != INVALID_ID) {
+                    edge.SetChannel(c, *cur);
+                }
+            }
+        }
+        for (uint32_t i = 0; i < servicesNum; ++i) {
+            double value;
+            const uint64_t bits = uint64_t(cur[3]) << 32 | cur[2];
+            memcpy(&value, &bits, sizeof(value));
+            AddService(cur[0], cur[1], value, cur[4], cur[5]);
+            Service& service = services.back();
+            if (!cur[6]) {
+                service.Kill();
+                aliveValue -= value;
+            }
+            const uint32_t stepsNum = cur[7];
+            cur += 8;
+            for (uint32_t j = 0; j < stepsNum; ++j, cur += 2) {
+                service.AddStep(cur[0], GetEdge(cur[0]).GetAnotherNode(service.GetPathEnd()), cur[1]);
+            }
+        }
+        partition = new Partition;
+        const uint32_t regionsNum = *cur++;
+        partition->regions.assign(cur, cur + nodesNum);
+        cur += nodesNum;
+        const uint32_t* borderOffsets = cur;
+        cur += regionsNum + 1;
+        for (uint32_t r = 0; r < regionsNum; ++r) {
+            partition->borderNodes.emplace_back(cur + borderOffsets[r], cur + borderOffsets[r + 1]);
+        }
+        cur += borderOffsets[regionsNum];
+        for (uint32_t r = 0; r < regionsNum; ++r, cur += regionsNum) {
+            partition->regionDistance.emplace_back(cur, cur + regionsNum);
+        }
+        distanceIndex = new HubLabels;
+        cur = distanceIndex->Attach(cur, nodesNum, mapping, size);
+        ASSERT(cur == words + IMAGE_HEADER_WORDS_NUM + payloadWordsNum);
+        return true;
+    }
+    void AddEdge(uint16_t node1, uint16_t node2) {
+        uint16_t id = edges.size() + 1;
+        edges.push_back(Edge(id, node1, node2, channelsNum));
+        GetNode(node1).AddEdge(id);
+        GetNode(node2).AddEdge(id);
+    }
+    void AddService(uint16_t start, uint16_t end, double value, uint8_t startChannel, uint8_t useChannelsNum) {
+        services.push_back(Service(services.size() + 1, start, end, value, startChannel, useChannelsNum));
+        aliveValue += value;
+    }
+    Node& GetNode(uint16_t id)                        {ASSERT_ID(id, nodes);    return nodes[id - 1];}
+    const Node& GetNodeConst(uint16_t id) const       {ASSERT_ID(id, nodes);    return nodes[id - 1];}
+    Edge& GetEdge(uint16_t id)                        {ASSERT_ID(id, edges);    return edges[id - 1];}
+    const Edge& GetEdgeConst(uint16_t id) const       {ASSERT_ID(id, edges);    return edges[id - 1];}
+    Service& GetService(uint16_t id)                  {ASSERT_ID(id, services); return services[id - 1];}
+    const Service& GetServiceConst(uint16_t id) const {ASSERT_ID(id, services); return services[id - 1];}
+    void AddServiceStep(uint16_t id, uint16_t edge, uint8_t startChannel) {
+        Service& s = GetService(id);
+        Edge& e = GetEdge(edge);
+        if (startChannel != s.GetLastChannelStart()) {
+            ASSERT(GetNodeConst(s.GetPathEnd()).IsAllowChangeChannel());
+            UpdateChangeChannelCnt(s.GetPathEnd(), true);
+        }
+        s.AddStep(edge, e.GetAnotherNode(s.GetPathEnd()), startChannel);
+        SetEdgeChannels(e, startChannel, s.GetUseChannelsNum(), id); // 记录业务路径的同时要在边的通道中标记业务
+    }
+    void AddServiceStep(uint16_t id, uint16_t edge) {
+        Service& s = GetService(id);
+        Edge& e = GetEdge(edge);
+        s.AddStep(edge, e.GetAnotherNode(s.GetPathEnd()));
+        SetEdgeChannels(e, s.GetLastChannelStart(), s.GetUseChannelsNum(), id); // 记录业务路径的同时要在边的通道中标记业务
+    }
+    uint8_t GetChannelsNum() const {return channelsNum;}
+    size_t GetNodesNum() const {return nodes.size();}
+    size_t GetEdgesNum() const {return edges.size();}
+    size_t GetServicesNum() const {return services.size();}
+    /**
+     * @brief 获取存活业务的总价值，在业务断开与恢复时增量维护
+     */
+    double GetValue() const {return aliveValue;}
+    /**
+     * @brief 获取场景复制以来因故障断开的业务价值之和（每个场景从初始场景复制，即为本场景的断开价值）
+     */
+    double GetKilledValue() const {return killedValue;}
+    /**
+     * @brief 获取场景复制以来重新规划成功的业务价值之和
+     */
+    double GetRevivedValue() const {return revivedValue;}
+    /**
+     * @brief 复活重新规划成功的业务
+     * @param id 业务编号
+     */
+    void ReviveService(uint16_t id) {
+        Service& s = GetService(id);
+        if (!s.IsAlive()) {
+            s.SetAlive();
+            aliveValue += s.GetValue();
+            revivedValue += s.GetValue();
+        }
+    }
+    /**
+     * 
+     */
+    void ResetChannelByPath(vector<Step> path, uint16_t id){
+        AddPath(path, id);
+    }
+    /**
+     * @brief 杀死指定边和路过的所有业务
+     * @param edge 指定边
+     * @return vector<uint16_t>&& 被杀死的业务
+     */
+    vector<uint16_t> Kill(uint16_t edge) {
+        Edge& e = GetEdge(edge);
+        InvalidateCapacity(0, e.GetMaxFreeRun());
+        e.Kill();
+        vector<uint16_t> ret;
+        for (uint8_t id = 1; id <= e.GetChannelsNum(); ++id) {
+            uint16_t s = e.GetChannel(id);
+            if (s != INVALID_ID && GetService(s).IsAlive()) {
+                ret.push_back(s);
+                GetService(s).Kill();
+                aliveValue -= GetService(s).GetValue();
+                killedValue += GetService(s).GetValue();
+            }
+        }
+        return ret;
+    }
+    /**
+     * @brief 容量预检：起点与终点之间是否存在每条边都有足够连续空闲通道的存活路径
+     * @param start 起点
+     * @param end 终点
+     * @param useChannelsNum 业务通道宽度
+     * @return bool 为false时业务必然无法规划，为true时仍需寻路确认（不考虑变通道次数）
+     * @note 按宽度缓存存活边中最长连续空闲通道数不小于该宽度的子图连通分量，
+     *       边的最长空闲段跨过某个宽度时才使该宽度的分量失效，失效后第一次查询时重建
+     */
+    bool IsRoutable(uint16_t start, uint16_t end, uint8_t useChannelsNum) {
+        ASSERT(useChannelsNum > 0);
+        if (useChannelsNum > channelsNum) {
+            return false;
+        }
+        if (start == end) {
+            return true;
+        }
+        if (!capacity.valid.Test(useChannelsNum - 1)) {
+            BuildCapacityComponents(useChannelsNum);
+        }
+        const auto& component = capacity.components[useChannelsNum - 1];
+        return component[start - 1] == component[end - 1];
+    }
+    /**
+     * @brief 将业务路径添加到场景中
+     * @param id 业务编号
+     */
+    void AddServicePath(uint16_t id) {
+        AddPath(GetService(id).GetPath(), id);
+    }
+    /**
+     * @brief 重新占用业务路径上的通道，不计换通道次数（路径的换通道次数已经计入，通道被其他路径的删除释放时使用）
+     * @param id 业务编号
+     */
+    void OccupyServicePath(uint16_t id) {
+        for (const auto& step : GetServiceConst(id).GetPath()) {
+            SetEdgeChannels(GetEdge(step.GetEdge()), step.GetStartChannel(), step.GetUseChannelsNum(), id);
+        }
+    }
+    /**
+     * @brief 各结点已用的换通道次数是否等于所有业务路径（含断开后未恢复的业务）在该结点换通道的次数之和
+     */
+    bool IsChangeChannelCntConsistent() const {
+        vector<int> used(GetNodesNum(), 0);
+        for (const auto& service : services) {
+            for (const auto& step : service.GetPath()) {
+                if (step.IsChannelChanged()) {
+                    ++used[step.GetStartNode() - 1];
+                }
+            }
+        }
+        for (const auto& node : nodes) {
+            if (node.GetChangeChannelCnt() != used[node.GetId() - 1]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    /**
+     * @brief 重设业务路径
+     * @param id 业务编号
+     * @param path 新路径
+     */
+    void ResetServicePath(uint16_t id, const vector<Step>& path) {
+        GetService(id).ResetPath(path);
+        AddServicePath(id);
+    }
+    /**
+     * @brief 重设业务路径
+     * @param id 业务编号
+     * @param path 新路径
+     * @param isReverse 是否需要翻转路径
+     */
+    void ResetServicePath(uint16_t id, vector<Step> path, bool isReverse) {
+        if (isReverse) {
+            reverse(path.begin(), path.end());
+        }
+        ResetServicePath(id, path);
+    }
+    /**
+     * @brief 隐藏业务路径
+     * @param id 需要隐藏的业务
+     */
+    void HideServicePath(uint16_t id) {
+        auto path = GetService(id).ClearPath();
+        DeletePath(path);
+        servicesHided.push_back(make_pair(id, path));
+    }
+    /**
+     * @brief 恢复被隐藏的路径，如果没有被隐藏过则不做任何操作
+     * @param id 被隐藏的业务
+     */
+    void RecoverServicePath(uint16_t id) {
+        for (auto it = servicesHided.begin(); it != servicesHided.end(); ++it) {
+            if (it->first == id) {
+                ResetServicePath(id, it->second);
+                break;
+            }
+        }
+    }
+    /**
+     * @brief 恢复被隐藏的路径，如果没有被隐藏过则不做任何操作
+     * @param id 被隐藏的业务
+     * @param resetServicePath 恢复时是否需要覆盖业务中已存储的路径
+     */
+    void RecoverServicePath(uint16_t id, bool resetServicePath) {
+        for (auto it = servicesHided.begin(); it != servicesHided.end(); ++it) {
+            if (it->first == id) {
+                if (resetServicePath) {
+                    ResetServicePath(id, it->second);
+                } else {
+                    AddPath(it->second, id);
+                }
+                break;
+            }
+        }
+    }
+    /**
+     * @brief 删除路径隐藏记录
+     * @param id 被隐藏的业务
+     * @param reDelete 是否需要再执行一次删除操作
+     */
+    void DeleteHidedPath(uint16_t id, bool reDelete = false) {
+        for (auto it = servicesHided.begin(); it != servicesHided.end(); ++it) {
+            if (it->first == id) {
+                if (reDelete) {
+                    DeletePath(it->second);
+                }
+                servicesHided.erase(it);
+                break;
+            }
+        }
+    }
+    /**
+     * @brief 清空被隐藏的路径
+     * @param reDelete 是否需要再执行一次删除操作
+     */
+    void ClearHidedPath(bool reDelete = false) {
+        if (reDelete) {
+            for (auto it : servicesHided) {
+                DeletePath(it.second);
+            }
+        }
+        servicesHided.clear();
+    }
+    /**
+     * @brief 开始试规划：此后通道占用与换通道次数的修改都记入撤销日志，由RollbackTrial撤销
+     * @param ids 试规划的业务，撤销时恢复其路径
+     * @note 试规划只能修改这些业务的路径；场景在试规划中被复制时日志随之复制，赋值回来后仍可撤销；
+     *       试规划可以嵌套，内层的业务必须是外层业务的子集
+     */
+    void BeginTrial(const vector<uint16_t>& ids) {
+        trials.emplace_back();
+        Trial& trial = trials.back();
+        for (auto id : ids) {
+            trial.services.push_back(GetServiceConst(id));
+        }
+        trial.servicesHided = servicesHided;
+    }
+    /**
+     * @brief 撤销最内层BeginTrial以来的修改，场景回到试规划前的状态（边的版本号除外，撤销也是一次修改）
+     */
+    void RollbackTrial() {
+        ASSERT(!trials.empty());
+        Trial trial = move(trials.back());
+        trials.pop_back();
+        vector<Trial> outers; // 撤销本身不记入外层的日志
+        outers.swap(trials);
+        for (auto it = trial.channels.rbegin(); it != trial.channels.rend(); ++it) {
+            SetEdgeChannels(GetEdge(it->edge), it->channel, 1, it->service);
+        }
+        for (auto it = trial.changeChannelCnts.rbegin(); it != trial.changeChannelCnts.rend(); ++it) {
+            GetNode(it->first).SetChangeChannelCnt(it->second);
+        }
+        for (auto& service : trial.services) {
+            GetService(service.GetId()) = move(service);
+        }
+        servicesHided = move(trial.servicesHided);
+        trials.swap(outers);
+    }
+    /**
+     * @brief 保留最内层BeginTrial以来的修改并结束该试规划，有外层试规划时修改并入外层的日志
+     */
+    void CommitTrial() {
+        ASSERT(!trials.empty());
+        Trial trial = move(trials.back());
+        trials.pop_back();
+        if (!trials.empty()) {
+            Trial& outer = trials.back();
+            outer.channels.insert(outer.channels.end(), trial.channels.begin(), trial.channels.end());
+            outer.changeChannelCnts.insert(outer.changeChannelCnts.end(), trial.changeChannelCnts.begin(),
+                                           trial.changeChannelCnts.end());
+        }
+    }
+
+private:
+    void AddPath(const vector<Step>& path, uint16_t id) {
+        for (auto step : path) {
+            SetEdgeChannels(GetEdge(step.GetEdge()), step.GetStartChannel(), step.GetUseChannelsNum(), id);
+            if (step.IsChannelChanged()) {
+                UpdateChangeChannelCnt(step.GetStartNode(), true);
+            }
+        }
+    }
+    void DeletePath(const vector<Step>& path) {
+        for (auto step : path) {
+            SetEdgeChannels(GetEdge(step.GetEdge()), step.GetStartChannel(), step.GetUseChannelsNum(), INVALID_ID);
+            if (step.IsChannelChanged()) {
+                UpdateChangeChannelCnt(step.GetStartNode(), false);
+            }
+        }
+    }
+    /**
+     * @brief 修改边的通道占用，并使最长空闲段跨过的宽度的容量分量失效
+     */
+    void SetEdgeChannels(Edge& e, uint8_t startChannel, uint8_t useChannelsNum, uint16_t id) {
+        if (!trials.empty()) {
+            for (uint8_t c = startChannel; c < startChannel + useChannelsNum; ++c) {
+                trials.back().channels.push_back({e.GetId(), c, e.GetChannel(c)});
+            }
+        }
+        const uint8_t before = e.GetMaxFreeRun();
+        e.SetChannels(startChannel, useChannelsNum, id);
+        if (e.IsAlive()) {
+            InvalidateCapacity(before, e.GetMaxFreeRun());
+        }
+    }
+    /**
+     * @brief 占用或释放结点的一次换通道次数，试规划时记入撤销日志
+     */
+    void UpdateChangeChannelCnt(uint16_t id, bool use) {
+        Node& node = GetNode(id);
+        if (!trials.empty()) {
+            trials.back().changeChannelCnts.emplace_back(id, node.GetChangeChannelCnt());
+        }
+        if (use) {
+            node.UseChangeChannelCnt();
+        } else {
+            node.ReleaseChangeChannelCnt();
+        }
+    }
+    /**
+     * @brief 使宽度在(min(a, b), max(a, b)]之间的容量分量失效
+     */
+    void InvalidateCapacity(uint8_t a, uint8_t b) {
+        for (uint8_t width = min(a, b) + 1; width <= max(a, b); ++width) {
+            capacity.valid.Reset(width - 1);
+        }
+    }
+    /**
+     * @brief 在最长空闲段不小于指定宽度的存活边上标记连通分量
+     */
+    void BuildCapacityComponents(uint8_t useChannelsNum) {
+        if (capacity.components.size() < channelsNum) {
+            capacity.components.resize(channelsNum);
+        }
+        auto& component = capacity.components[useChannelsNum - 1];
+        component.assign(GetNodesNum(), INVALID_ID);
+        vector<uint16_t> queue;
+        queue.reserve(GetNodesNum());
+        for (uint16_t root = 1; root <= GetNodesNum(); ++root) {
+            if (component[root - 1] != INVALID_ID) {
+                continue;
+            }
+            component[root - 1] = root;
+            queue.assign(1, root);
+            for (size_t i = 0; i < queue.size(); ++i) {
+                const uint16_t node = queue[i];
+                for (auto eid : GetNodeConst(node).GetConnectedEdges()) {
+                    const Edge& e = GetEdgeConst(eid);
+                    if (!e.IsAlive() || e.GetMaxFreeRun() < useChannelsNum) {
+                        continue;
+                    }
+                    const uint16_t next = e.GetAnotherNode(node);
+                    if (component[next - 1] == INVALID_ID) {
+                        component[next - 1] = root;
+                        queue.push_back(next);
+                    }
+                }
+            }
+        }
+        capacity.valid.Set(useChannelsNum - 1);
+    }
+    /**
+     * @brief 初始拓扑的邻接表，下标为结点编号减一
+     */
+    vector<vector<uint16_t>> GetAdjacency() const {
+        vector<vector<uint16_t>> adjacency(GetNodesNum());
+        for (uint16_t nid = 1; nid <= GetNodesNum(); ++nid) {
+            for (auto eid : GetNodeConst(nid).GetConnectedEdges()) {
+                adjacency[nid - 1].push_back(GetEdgeConst(eid).GetAnotherNode(nid));
+            }
+        }
+        return adjacency;
+    }
+    /**
+     * @brief 在初始拓扑上从多个起点出发做BFS
+     * @param sources 起点
+     * @return vector<uint16_t> 各结点到最近起点的跳数距离，不可达时为UINT16_MAX
+     */
+    vector<uint16_t> Bfs(const vector<uint16_t>& sources) const {
+        vector<uint16_t> distance(GetNodesNum(), UINT16_MAX);
+        vector<uint16_t> visited(sources); // 兼作队列
+        for (auto node : sources) {
+            distance[node - 1] = 0;
+        }
+        for (size_t i = 0; i < visited.size(); ++i) {
+            const uint16_t node = visited[i];
+            for (auto eid : GetNodeConst(node).GetConnectedEdges()) {
+                const uint16_t next = GetEdgeConst(eid).GetAnotherNode(node);
+                if (distance[next - 1] == UINT16_MAX) {
+                    distance[next - 1] = distance[node - 1] + 1;
+                    visited.push_back(next);
+                }
+            }
+        }
+        return distance;
+    }
+
+private:
+    uint8_t channelsNum; // 每条边的通道数
+    vector<Node> nodes; // 结点表
+    vector<Edge> edges; // 边表
+    vector<Service> services; // 业务表
+    vector<pair<uint16_t, vector<Step>>> servicesHided; // 隐藏的业务表路径
+    double aliveValue = 0.0; // 存活业务的总价值
+    double killedValue = 0.0; // 因故障断开的业务价值之和
+    double revivedValue = 0.0; // 重新规划成功的业务价值之和
+    HubLabels* distanceIndex = nullptr; // 跳数距离索引
+    struct Partition {
+        vector<uint16_t> regions; // 各结点所属区域的下标
+        vector<vector<uint16_t>> borderNodes; // 各区域的边界结点
+        vector<vector<uint16_t>> regionDistance; // 区域之间的边界距离
+    };
+    Partition* partition = nullptr; // 区域划分，与结点距离表一样在所有场景间共享
+    struct CapacityIndex {
+        ChannelMask valid{}; // 第i位为1表示宽度i+1的连通分量有效
+        vector<vector<uint16_t>> components; // 以宽度减一为下标，各结点所在分量的根结点
+    };
+    CapacityIndex capacity; // 容量预检的按宽度连通分量
+    struct Trial {
+        struct ChannelRecord {
+            uint16_t edge;
+            uint8_t channel;
+            uint16_t service; // 修改前占用该通道的业务
+        };
+        vector<Service> services; // 试规划的业务在开始时的副本
+        vector<pair<uint16_t, vector<Step>>> servicesHided; // 开始时的隐藏路径表
+        vector<ChannelRecord> channels; // 通道占用的修改，按修改顺序
+        vector<pair<uint16_t, uint8_t>> changeChannelCnts; // (结点, 修改前已用的换通道次数)，按修改顺序
+    };
+    vector<Trial> trials; // 试规划的撤销日志，嵌套时只记入最内层
+};
+
+/**
+ * @brief 路径缓存，按(起点, 终点, 通道宽度)保存最近寻路成功的路径，在所有场景间共享
+ * @note 缓存路径记录存入时各边的通道占用版本号，取用时版本号未变的边无需再检查通道，
+ *       变化过的边检查窗口是否仍然空闲；经过断边或窗口已被占用的路径直接淘汰
+ */
+class PathCache {
+public:
+    static constexpr size_t WAYS = 4; // 每个键最多保存的路径数
+
+public:
+    /**
+     * @brief 查找在当前场景中仍然可用的缓存路径，每条候选路径的检查复杂度为路径长度
+     * @param s 场景（业务的老路径需要事先隐藏）
+     * @param service 业务
+     * @param remainChangeChannelCnt 各结点剩余的换通道次数（检查时临时扣除，返回前恢复）
+     * @param path 命中的路径
+     * @return true 命中
+     * @return false 未命中
+     */
+    bool Lookup(const Scene& s, const Service& service, vector<int>& remainChangeChannelCnt, vector<Step>& path) {
+        ++lookupsCnt;
+        auto it = entries.find(Key(service));
+        if (it == entries.end()) {
+            return false;
+        }
+        vector<Entry>& ways = it->second;
+        for (size_t i = 0; i < ways.size();) {
+            if (IsValid(s, ways[i], remainChangeChannelCnt)) {
+                path = ways[i].path;
+                rotate(ways.begin(), ways.begin() + i, ways.begin() + i + 1); // 移到最前面
+                ++hitsCnt;
+                return true;
+            }
+            ways.erase(ways.begin() + i);
+            ++evictionsCnt;
+        }
+        return false;
+    }
+    /**
+     * @brief 保存寻路成功的路径，需要在路径加入场景之前调用
+     * @param s 场景
+     * @param service 业务
+     * @param path 路径
+     */
+    void Store(const Scene& s, const Service& service, const vector<Step>& path) {
+        Entry entry{path, {}};
+        for (const auto& step : path) {
+            entry.versions.push_back(s.GetEdgeConst(step.GetEdge()).GetVersion());
+        }
+        vector<Entry>& ways = entries[Key(service)];
+        for (auto it = ways.begin(); it != ways.end(); ++it) {
+            if (IsSamePath(it->path, path)) {
+                ways.erase(it);
+                break;
+            }
+        }
+        ways.insert(ways.begin(), entry);
+        if (ways.size() > WAYS) {
+            ways.pop_back();
+        }
+    }
+    /**
+     * @brief 记录一次未命中后的寻路耗时，用于估计命中节省的时间
+     * @param seconds 寻路耗时（秒）
+     */
+    void AddSearchTime(double seconds) {
+        ++searchesCnt;
+        searchTime += seconds;
+    }
+    /**
+     * @brief 输出本场景的命中率和节省的时间（按未命中时的平均寻路耗时估计），并清空统计
+     */
+    void LogStats() {
+        LOG_INFO("路径缓存：查询 %lu 命中 %lu 命中率 %.1f%% 淘汰 %lu 节省约 %.3fms\n", lookupsCnt, hitsCnt,
+                 lookupsCnt ? 100.0 * hitsCnt / lookupsCnt : 0.0, evictionsCnt,
+                 searchesCnt ? 1000.0 * searchTime / searchesCnt * hitsCnt : 0.0);
+        lookupsCnt = hitsCnt = evictionsCnt = searchesCnt = 0;
+        searchTime = 0.0;
+    }
+
+private:
+    struct Entry {
+        vector<Step> path;
+        vector<uint32_t> versions; // 存入时路径上各边的通道占用版本号
+    };
+
+private:
+    static uint64_t Key(const Service& service) {
+        return (uint64_t(service.GetStart()) << 32) | (uint64_t(service.GetEnd()) << 16) | service.GetUseChannelsNum();
+    }
+    static bool IsSamePath(const vector<Step>& path1, const vector<Step>& path2) {
+        if (path1.size() != path2.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < path1.size(); ++i) {
+            if (path1[i].GetEdge() != path2[i].GetEdge() || path1[i].GetStartChannel() != path2[i].GetStartChannel()) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static bool IsValid(const Scene& s, const Entry& entry, vector<int>& remainChangeChannelCnt) {
+        for (size_t i = 0; i < entry.path.size(); ++i) {
+            const Step& step = entry.path[i];
+            const Edge& edge = s.GetEdgeConst(step.GetEdge());
+            if (!edge.IsAlive()) {
+                return false;
+            }
+            if (edge.GetVersion() != entry.versions[i] &&
+                !edge.CheckChannelsFree(step.GetStartChannel(), step.GetUseChannelsNum())) {
+                return false;
+            }
+        }
+        // 同一结点可能在路径上多次换通道，逐步扣除后再恢复
+        size_t used = 0;
+        bool isValid = true;
+        for (; used < entry.path.size() && isValid; ++used) {
+            const Step& step = entry.path[used];
+            if (step.IsChannelChanged() && --remainChangeChannelCnt[step.GetStartNode() - 1] < 0) {
+                isValid = false;
+            }
+        }
+        for (size_t i = 0; i < used; ++i) {
+            const Step& step = entry.path[i];
+            if (step.IsChannelChanged()) {
+                ++remainChangeChannelCnt[step.GetStartNode() - 1];
+            }
+        }
+        return isValid;
+    }
+
+private:
+    unordered_map<uint64_t, vector<Entry>> entries; // 缓存的路径，每个键下按最近使用排序
+    size_t lookupsCnt = 0; // 本场景查询次数
+    size_t hitsCnt = 0; // 本场景命中次数
+    size_t evictionsCnt = 0; // 本场景淘汰的路径数
+    size_t searchesCnt = 0; // 本场景未命中后的寻路次数
+    double searchTime = 0.0; // 本场景未命中后的寻路总耗时（秒）
+};
+
+/**
+ * @brief 解决方案
+ */
+class Solution {
+public:
+    Solution(const Scene& s) : s(s) {}
+    virtual ~Solution() = default;
+
+public:
+    /**
+     * @brief 处理一次边故障
+     * @param edge 故障边
+     * @param print 是否向标准输出打印结果（回放时不打印）
+     * @return vector<uint16_t> 成功重新规划的业务编号，新路径可从GetScene()读取
+     */
+    vector<uint16_t> Handle(uint16_t edge, bool print = true) {
+        return Handle(vector<uint16_t>{edge}, print).front();
+    }
+    /**
+     * @brief 一次处理同时发生的多条边故障：先断开全部故障边，再对所有受影响业务做一次联合规划，
+     *        按协议逐条故障边输出由该边断开的业务的新路径
+     * @note 新路径避开整批故障边，且不占用同批中其他受影响业务的原路径，逐边输出时仍然合法
+     * @param edges 故障边（按发生顺序）
+     * @param print 是否向标准输出打印结果
+     * @return vector<vector<uint16_t>> 每条故障边对应的成功重新规划的业务编号
+     */
+    virtual vector<vector<uint16_t>> Handle(const vector<uint16_t>& edges, bool print = true) = 0;
+    double GetValue() const {
+        return s.GetValue();
+    }
+    const Scene& GetScene() const {
+        return s;
+    }
+    void SetScene(const Scene& scene) {
+        s = scene;
+    }
+    /**
+     * @brief 输出统计
+     * @param name 策略名
+     */
+    virtual void LogStats(const string& name = "") const = 0;
+
+protected:
+    void PrintAns(const vector<uint16_t>& service) const {
+        printf("%lu\n", service.size());
+        for (auto bid : service) {
+            const Service& ser = s.GetServiceConst(bid);
+            const vector<Step>& path = ser.GetPath();
+            printf("%u %lu\n", ser.GetId(), path.size());
+            for (auto step : path) {
+                printf("%u %u %u ", step.GetEdge(), step.GetStartChannel(), step.GetEndChannel());
+            }
+            printf("\n");
+        }
+        fflush(stdout);
+    }
+
+protected:
+    Scene s;
+};
+
+/**
+ * @brief 逐个规划的解决方案：每次故障先排序、前瞻受影响的业务，再交给规划器，规划受截止时间约束
+ */
+class PlanningSolution : public Solution {
+public:
+    explicit PlanningSolution(const Scene& s) : Solution(s) {}
+
+public:
+    using Solution::Handle;
+    vector<vector<uint16_t>> Handle(const vector<uint16_t>& edges, bool print = true) override {
+        const DeadlineStats before = deadlineStats;
+        deadline = isDeadlineEnabled ? chrono::steady_clock::now() + handleBudget : chrono::steady_clock::time_point::max();
+        vector<uint16_t> services;
+        unordered_map<uint16_t, size_t> killedBy; // 业务编号 -> 断开该业务的故障边下标
+        for (size_t i = 0; i < edges.size(); ++i) {
+            for (auto sid : s.Kill(edges[i])) {
+                services.push_back(sid);
+                killedBy[sid] = i;
+            }
+        }
+        vector<uint16_t> output;
+        Order(services);
+        Planning(services, output);
+        ++deadlineStats.handles;
+        ASSERT(s.IsChangeChannelCntConsistent());
+        if (deadlineStats.cutSearches != before.cutSearches || deadlineStats.skippedServices != before.skippedServices) {
+            ++deadlineStats.cutHandles;
+        }
+        vector<vector<uint16_t>> outputs(edges.size());
+        for (auto sid : output) {
+            s.ReviveService(sid);
+            outputs[killedBy[sid]].push_back(sid);
+        }
+        if (print) {
+            for (const auto& o : outputs) {
+                PrintAns(o);
+            }
+        }
+        return outputs;
+    }
+    /**
+     * @brief 设置每次故障的规划时间
+     */
+    void SetHandleBudget(chrono::milliseconds budget) {
+        handleBudget = budget;
+    }
+    /**
+     * @brief 不限制规划时间，规划结果不再依赖运行速度（记录与回放时使用）
+     */
+    void DisableDeadline() {
+        isDeadlineEnabled = false;
+    }
+    /**
+     * @brief 输出截止时间的统计
+     * @param name 策略名
+     */
+    void LogStats([[maybe_unused]] const string& name = "") const override { // 非DEBUG编译时LOG_INFO为空
+        LOG_INFO("截止时间%s：故障 %u 被打断 %u 中止搜索 %u 跳过业务 %u\n", name.c_str(), deadlineStats.handles,
+                 deadlineStats.cutHandles, deadlineStats.cutSearches, deadlineStats.skippedServices);
+    }
+
+protected:
+    static constexpr size_t LOOKAHEAD_DEPTH = 3; // 规划顺序前瞻时枚举排列的业务数
+    static constexpr chrono::milliseconds HANDLE_BUDGET{1000}; // 每次故障的默认规划时间
+    static constexpr int LOOKAHEAD_BUDGET_RATIO = 4; // 前瞻最多使用规划时间的几分之一
+
+protected:
+    struct DeadlineStats {
+        uint32_t handles = 0; // 处理的故障数
+        uint32_t cutHandles = 0; // 规划被截止时间打断的故障数
+        uint32_t cutSearches = 0; // 超出时间份额而中止的搜索数
+        uint32_t skippedServices = 0; // 到达截止时间后未尝试的业务数
+    };
+
+protected:
+    /**
+     * @brief 是否已到达本次故障的截止时间
+     */
+    bool IsPastDeadline() const {
+        return chrono::steady_clock::now() >= deadline;
+    }
+    /**
+     * @brief 把剩余时间平分给剩余的业务，得到下一个业务的搜索截止时间
+     * @param remainServicesNum 包括下一个业务在内剩余的业务数
+     */
+    chrono::steady_clock::time_point GetShareEnd(size_t remainServicesNum) const {
+        const auto now = chrono::steady_clock::now();
+        return deadline <= now ? now : now + (deadline - now) / int64_t(max<size_t>(remainServicesNum, 1));
+    }
+
+protected:
+    chrono::milliseconds handleBudget = HANDLE_BUDGET; // 每次故障的规划时间
+    bool isDeadlineEnabled = true; // 是否限制规划时间
+    chrono::steady_clock::time_point deadline = chrono::steady_clock::time_point::max(); // 本次故障的截止时间
+    DeadlineStats deadlineStats; // 截止时间的统计
+
+private:
+    /**
+     * @brief 规划顺序：按ServiceCompare排序，再对争抢最激烈的LOOKAHEAD_DEPTH个业务枚举排列试规划，取恢复价值最高的排列
+     * @param services 受到影响的业务编号
+     */
+    void Order(vector<uint16_t>& services) {
+        sort(services.begin(), services.end(), [=] (uint16_t s1, uint16_t s2) {
+            return ServiceCompare(s.GetServiceConst(s1), s.GetServiceConst(s2));
+        });
+        Lookahead(services);
+    }
+    /**
+     * @brief 前瞻：选出争抢最激烈的LOOKAHEAD_DEPTH个业务，在当前场景上依次试规划它们的每种排列并撤销，
+     *        把恢复价值最高的排列依次放回这些业务原来的位置
+     * @note 业务的争抢程度为其老路径上各存活边被其他受影响业务的老路径经过的次数之和，相同时取靠前的业务；
+     *       最多使用规划时间的1/LOOKAHEAD_BUDGET_RATIO，到时后不再尝试其余排列；
+     *       试规划中的中止搜索与跳过业务不计入截止时间的统计
+     * @param services 已排好序的业务编号
+     */
+    void Lookahead(vector<uint16_t>& services) {
+        const size_t depth = min(LOOKAHEAD_DEPTH, services.size());
+        if (depth < 2) {
+            return;
+        }
+        unordered_map<uint16_t, uint16_t> edgeUsers; // 存活边 -> 经过该边的受影响业务数
+        for (auto sid : services) {
+            for (const auto& step : s.GetServiceConst(sid).GetPath()) {
+                if (s.GetEdgeConst(step.GetEdge()).IsAlive()) {
+                    ++edgeUsers[step.GetEdge()];
+                }
+            }
+        }
+        vector<uint32_t> contention(services.size(), 0); // 各业务的争抢程度
+        for (size_t i = 0; i < services.size(); ++i) {
+            for (const auto& step : s.GetServiceConst(services[i]).GetPath()) {
+                auto it = edgeUsers.find(step.GetEdge());
+                if (it != edgeUsers.end()) {
+                    contention[i] += it->second - 1;
+                }
+            }
+        }
+        vector<size_t> slots(services.size()); // 参与前瞻的业务在列表中的位置
+        for (size_t i = 0; i < slots.size(); ++i) {
+            slots[i] = i;
+        }
+        stable_sort(slots.begin(), slots.end(), [&] (size_t i, size_t j) {return contention[i] > contention[j];});
+        slots.resize(depth);
+        sort(slots.begin(), slots.end());
+        const auto handleDeadline = deadline; // 前瞻只使用一部分规划时间，试规划同样遵守
+        const DeadlineStats stats = deadlineStats;
+        if (isDeadlineEnabled) {
+            deadline = min(deadline, chrono::steady_clock::now() + handleBudget / LOOKAHEAD_BUDGET_RATIO);
+        }
+        vector<size_t> perm(depth); // 排列，从原顺序开始枚举，价值相同时保留原顺序
+        for (size_t i = 0; i < depth; ++i) {
+            perm[i] = i;
+        }
+        vector<uint16_t> best;
+        double bestValue = -1.0;
+        double totalValue = 0.0; // 全部恢复时的价值，达到后不必再尝试其他排列
+        for (auto slot : slots) {
+            best.push_back(services[slot]);
+            totalValue += s.GetServiceConst(services[slot]).GetValue();
+        }
+        do {
+            vector<uint16_t> trial, output;
+            for (auto i : perm) {
+                trial.push_back(services[slots[i]]);
+            }
+            s.BeginTrial(trial);
+            Planning(trial, output);
+            s.RollbackTrial();
+            double value = 0.0;
+            for (auto sid : output) {
+                value += s.GetServiceConst(sid).GetValue();
+            }
+            if (value > bestValue) {
+                bestValue = value;
+                best = trial;
+            }
+        } while (bestValue < totalValue && !IsPastDeadline() && next_permutation(perm.begin(), perm.end()));
+        deadline = handleDeadline;
+        deadlineStats = stats;
+        for (size_t i = 0; i < depth; ++i) {
+            services[slots[i]] = best[i];
+        }
+    }
+    /**
+     * @brief 业务比较函数
+     * @param s1 业务1
+     * @param s2 业务2
+     * @return true 在排序时将业务1放在前面
+     * @return false 在排序时将业务2放在前面
+     */
+    virtual bool ServiceCompare(const Service& s1, const Service& s2) const  = 0;
+    /**
+     * @brief 规划器
+     * @param services 受到影响的业务编号 
+     * @param output 成功重新规划的业务编号（放入output的业务会自动被设置为复活）
+     */
+    virtual void Planning(const vector<uint16_t>& services, vector<uint16_t>& output) = 0;
+};
+/**
+ * @brief 徐天泽的算法
+ */
+class SolutionXTZ final : public PlanningSolution {
+public:
+    /**
+     * @brief 规划方式
+     */
+    enum class Mode {
+        SEARCH, // 受影响业务少时精确规划，否则逐个A*
+        BFS, // 逐个BFS
+    };
+
+public:
+    SolutionXTZ(const Scene& s, PathCache& cache, Mode mode = Mode::SEARCH) : PlanningSolution(s), cache(cache), mode(mode) {}
+
+public:
+    void LogStats(const string& name = "") const override {
+        PlanningSolution::LogStats(name);
+        LOG_INFO("容量预检%s：拒绝搜索 %u\n", name.c_str(), rejectedSearches);
+        LOG_INFO("松弛搜索%s：路径不可行 %u 次，精确搜索超过结点数上限 %u 次\n", name.c_str(), exactSearches, greedySearches);
+    }
+
+private:
+    struct AStarNode {
+        uint16_t n; // 终点结点
+        uint8_t c; // 使用的通道
+        uint16_t e; // 抵达终点的边
+        AStarNode* f; // 父结点
+        double passed; // 已走过的路的总成本
+        double remain; // 剩余距离
+        uint16_t steps; // 路径上的步数
+        uint32_t order; // 生成顺序，代价相同时先生成的先遍历
+        double Cost() const {return passed + remain;}
+        bool operator<(const AStarNode& rhs) const {
+            return Cost() != rhs.Cost() ? Cost() < rhs.Cost() : order < rhs.order;
+        }
+    };
+    /**
+     * @brief 标号搜索的方式
+     */
+    enum class LabelMode {
+        RELAXED, // 允许重复经过结点，按代价和步数支配
+        EXACT, // 不重复经过结点，支配者路径上的结点还要都在新结点的路径上
+        GREEDY, // 不重复经过结点，按代价和步数支配，可能漏掉可行路径
+    };
+
+private:
+    static constexpr size_t EXACT_MAX_SERVICES = 8; // 使用精确规划的最大业务数，超过时使用贪心
+    static constexpr size_t EXACT_CANDIDATES_NUM = 4; // 精确规划中每个业务额外枚举的候选路径数
+    static constexpr size_t EXACT_NODE_LIMIT = 1 << 16; // 精确规划中分支定界的最大结点数
+    static constexpr uint32_t SEARCH_CLOCK_INTERVAL = 256; // 搜索中每取出多少个结点检查一次时间
+    static constexpr size_t EXACT_SEARCH_NODE_LIMIT = 1 << 12; // 精确标号搜索的最大结点数
+
+private:
+    /**
+     * @brief 业务比较函数
+     * @param s1 业务1
+     * @param s2 业务2
+     * @return true 在排序时将业务1放在前面
+     * @return false 在排序时将业务2放在前面
+     */
+    bool ServiceCompare(const Service& s1, const Service& s2) const override {
+        if (s1.GetValue() == s2.GetValue()) {
+            return s1.GetUseChannelsNum() < s2.GetUseChannelsNum();
+        }
+        return s1.GetValue() > s2.GetValue();
+    }
+    /**
+     * @brief 规划器
+     * @param services 受到影响的业务编号 
+     * @param output 成功重新规划的业务编号（放入output的业务会自动被设置为复活）
+     */
+    void PrintEdgeByService(Service service){
+        vector<Step> path = service.GetPath();
+        for(auto step : path){
+            Edge& e = s.GetEdge(step.GetEdge());
+            // printf("边%d的第%d个通道占用情况%d\n", e.GetId(), step.GetStartChannel(), e.GetChannel(step.GetStartChannel()));
+        }
+    }
+    /**
+     * @brief 规划器
+     * @param services 受到影响的业务编号 
+     * @param output 成功重新规划的业务编号（放入output的业务会自动被设置为复活）
+     */
+    void Planning(const vector<uint16_t>& services, vector<uint16_t>& output) override {
+        if (mode == Mode::BFS) {
+            BFS(services, output);
+        } else if (services.size() <= EXACT_MAX_SERVICES) { // 受影响的业务较少时使用精确规划
+            Exact(services, output);
+        } else {
+            AStar(services, output);
+        }
+    }
+    void BFS(const vector<uint16_t>& services, vector<uint16_t>& output) {
+        vector<int> remainChangeChannelCnt = GetRemainChangeChannelCnt();
+        size_t attempted = 0; // 已尝试的业务数，到达截止时间后其余业务不再尝试
+        vector<bool> isRerouted(services.size(), false); // 各业务是否找到了新路径
+        for (; attempted < services.size(); ++attempted) {
+            if (IsPastDeadline()) {
+                deadlineStats.skippedServices += services.size() - attempted;
+                break;
+            }
+            const uint16_t sid = services[attempted];
+            s.HideServicePath(sid);
+            const auto& service = s.GetService(sid);
+            const uint16_t start = service.GetStart();
+            const uint16_t end = service.GetEnd();
+            struct BfsNode {
+                uint16_t n; // 终点
+                uint8_t c; // 使用的通道
+                uint16_t e; // 抵达终点的边
+                BfsNode* f; // 父结点
+            };
+            queue<BfsNode*> openSet; // 开集，待遍历
+            queue<BfsNode*> closeSet; // 闭集，已完成遍历
+            BfsNode* endNode = nullptr;
+            for (uint8_t round = 0; round <= 1; ++round) {
+                vector<bool> visited(s.GetNodesNum(), false);
+                bool allowChangeChannel = bool(round); // 先不允许换通道，没有方案再换通道
+                // 推入搜索起点
+                openSet.push(new BfsNode{start, service.GetDefaultChannelStart(), INVALID_ID, nullptr});
+                while (!openSet.empty()) { // BFS
+                    auto node = openSet.front();
+                    openSet.pop();
+                    if (node->n == end) {
+                        endNode = node;
+                        closeSet.push(node);
+                        break;
+                    }
+                    visited[node->n - 1] = true;
+                    vector<uint16_t> edges = s.GetNodeConst(node->n).GetConnectedEdges();
+                    sort(edges.begin(), edges.end(), [=](uint16_t e1, uint16_t e2) {
+                        uint16_t n1 = s.GetEdge(e1).GetAnotherNode(node->n);
+                        uint16_t n2 = s.GetEdge(e2).GetAnotherNode(node->n);
+                        const uint16_t d1 = s.GetNodeDistance(n1, end);
+                        const uint16_t d2 = s.GetNodeDistance(n2, end);
+                        if (d1 != d2) {
+                            return d1 < d2;
+                        }
+                        return s.GetNodeConst(n1).GetRemainChangeChannelCnt() > s.GetNodeConst(n2).GetRemainChangeChannelCnt();
+                    });
+                    for (auto e : edges) { // 从连接的边中找另一端结点
+                        Edge& edge = s.GetEdge(e);
+                        if (!edge.IsAlive()) { // 断边不考虑
+                            continue;
+                        }
+                        uint16_t nextNode = edge.GetAnotherNode(node->n);
+                        if (visited[nextNode - 1]) { // 遍历过的点不考虑
+                            continue;
+                        }
+                        uint8_t nextChannel = node->c;
+                        // 如果通道被占用，特殊处理
+                        // !TODO:查询时间复杂度过高，需要优化
+                        if (!edge.CheckChannelsFree(nextChannel, service.GetUseChannelsNum())) {
+                            if (!allowChangeChannel || (node->f != nullptr &&
+                                CountChangeChannel(node, node->n) >= remainChangeChannelCnt[node->n - 1])) {
+                                continue;
+                            }
+                            nextChannel = edge.AllocateChannel(service.GetUseChannelsNum());
+                            if (nextChannel == 0) { // 没找到能分配的通道
+                                continue;
+                            }
+                        }
+                        openSet.push(new BfsNode{nextNode, nextChannel, e, node});
+                    }
+                    closeSet.push(node);
+                } 
+                if (endNode) { // 找到了方案就不再尝试
+                    break;
+                }
+            }
+            if (endNode) {
+                vector<Step> path;
+                while (endNode->f != nullptr) {
+                    path.push_back(Step(endNode->e, endNode->f->n, endNode->c, service.GetUseChannelsNum(), endNode->f->f ? endNode->c != endNode->f->c : false));
+                    endNode = endNode->f;
+                }
+                s.ResetServicePath(sid, path, true);
+                output.push_back(sid);
+                isRerouted[attempted] = true;
+                UseChangeChannelCnt(remainChangeChannelCnt, s.GetServiceConst(sid).GetPath());
+            }
+            while (!openSet.empty()) {
+                delete openSet.front();
+                openSet.pop();
+            }
+            while (!closeSet.empty()) {
+                delete closeSet.front();
+                closeSet.pop();
+            }
+            s.RecoverServicePath(sid, endNode == nullptr); // 恢复老路径，但不覆盖掉新路径
+        }
+        // 所有新路径至此已经生成完毕
+        s.ClearHidedPath(true); // 先不考虑新路径是否包含老路径，将老路径全部再删除一遍（含换通道次数）
+        // 新路径的通道可能和老路径重叠而被上面释放，重新占用；新路径的换通道次数在ResetServicePath时已经计入，
+        // 失败业务的老路径在上面被多删了一次，整条加回。未尝试的业务的老路径从未删除
+        for (size_t i = 0; i < attempted; ++i) {
+            if (isRerouted[i]) {
+                s.OccupyServicePath(services[i]);
+            } else {
+                s.AddServicePath(services[i]);
+            }
+        }
+    }
+    void AStar(const vector<uint16_t>& services, vector<uint16_t>& output) {
+        vector<int> remainChangeChannelCnt = GetRemainChangeChannelCnt();
+        size_t attempted = 0; // 已尝试的业务数，到达截止时间后其余业务不再尝试
+        vector<bool> isRerouted(services.size(), false); // 各业务是否找到了新路径
+        for (; attempted < services.size(); ++attempted) {
+            if (IsPastDeadline()) {
+                deadlineStats.skippedServices += services.size() - attempted;
+                break;
+            }
+            const uint16_t sid = services[attempted];
+            searchEnd = GetShareEnd(services.size() - attempted);
+            s.HideServicePath(sid);
+            vector<Step> path;
+            bool isSuccess = cache.Lookup(s, s.GetServiceConst(sid), remainChangeChannelCnt, path);
+            if (!isSuccess) { // 缓存未命中时再寻路
+                const auto begin = chrono::steady_clock::now();
+                isSuccess = Search(sid, remainChangeChannelCnt, path);
+                cache.AddSearchTime(chrono::duration<double>(chrono::steady_clock::now() - begin).count());
+                if (isSuccess) {
+                    cache.Store(s, s.GetServiceConst(sid), path);
+                }
+            }
+            if (isSuccess) {
+                s.ResetServicePath(sid, path);
+                output.push_back(sid);
+                UseChangeChannelCnt(remainChangeChannelCnt, path);
+                isRerouted[attempted] = true;
+            }
+            s.RecoverServicePath(sid, !isSuccess); // 恢复老路径
+        }
+        // 所有新路径至此已经生成完毕
+        s.ClearHidedPath(true); // 先不考虑新路径是否包含老路径，将老路径全部再删除一遍（含换通道次数）
+        // 新路径的通道可能和老路径重叠而被上面释放，重新占用；新路径的换通道次数在ResetServicePath时已经计入，
+        // 失败业务的老路径在上面被多删了一次，整条加回。未尝试的业务的老路径从未删除
+        for (size_t i = 0; i < attempted; ++i) {
+            if (isRerouted[i]) {
+                s.OccupyServicePath(services[i]);
+            } else {
+                s.AddServicePath(services[i]);
+            }
+        }
+    }
+    /**
+     * @brief 在当前场景上为单个业务寻路，不修改场景（业务的老路径需要事先隐藏）
+     * @note 先做容量预检，不存在足够宽的存活路径时直接失败；再只在起点与终点之间的走廊区域内搜索
+     *       长度不超过两点距离加CORRIDOR_SLACK的路径，经过走廊外区域的路径一定更长，因此找到的路径
+     *       即为全局最短；找不到时再在整个网络上搜索
+     * @param sid 业务编号
+     * @param remainChangeChannelCnt 各结点剩余的换通道次数
+     * @param path 找到的路径（从起点到终点）
+     * @return true 寻路成功
+     * @return false 寻路失败
+     */
+    bool Search(uint16_t sid, const vector<int>& remainChangeChannelCnt, vector<Step>& path) {
+        const auto& service = s.GetServiceConst(sid);
+        if (!s.IsRoutable(service.GetStart(), service.GetEnd(), service.GetUseChannelsNum())) {
+            ++rejectedSearches;
+            return false;
+        }
+        vector<bool> corridor;
+        if (s.GetCorridor(service.GetStart(), service.GetEnd(), corridor) &&
+            AStarSearch(sid, remainChangeChannelCnt, &corridor,
+                        s.GetNodeDistance(service.GetStart(), service.GetEnd()) + Scene::CORRIDOR_SLACK, path)) {
+            return true;
+        }
+        return !isSearchCut && AStarSearch(sid, remainChangeChannelCnt, nullptr, UINT16_MAX, path);
+    }
+    /**
+     * @brief A*寻路
+     * @note 先做松弛搜索：允许重复经过结点，剩余换通道次数大于0的结点都可以换通道，此时结点之后能否走通只取决于
+     *       状态(结点, 通道)，代价和步数都不高于新结点的同状态结点支配新结点。松弛问题的解包含所有可行路径，
+     *       因此松弛搜索失败时业务一定无法恢复；找到的路径不重复经过边且各结点换通道次数不超过剩余次数时即为最短的
+     *       可行路径。否则退回只搜索不重复经过结点的路径，支配还要求支配者路径上的结点都在新结点的路径上；
+     *       生成的结点数超过EXACT_SEARCH_NODE_LIMIT时改为只按代价和步数支配，此时可能漏掉可行路径
+     * @param sid 业务编号
+     * @param remainChangeChannelCnt 各结点剩余的换通道次数
+     * @param corridor 允许扩展的区域，为空时不限制
+     * @param maxLength 路径的最大长度，剩余距离加已走步数超过该值的结点不再生成
+     * @param path 找到的路径（从起点到终点）
+     * @return true 寻路成功
+     * @return false 寻路失败
+     */
+    bool AStarSearch(uint16_t sid, const vector<int>& remainChangeChannelCnt, const vector<bool>* corridor,
+                     uint16_t maxLength, vector<Step>& path) {
+        if (!LabelSearch(sid, remainChangeChannelCnt, corridor, maxLength, LabelMode::RELAXED, path)) {
+            return false;
+        }
+        if (IsPathFeasible(path, remainChangeChannelCnt)) {
+            return true;
+        }
+        ++exactSearches;
+        if (LabelSearch(sid, remainChangeChannelCnt, corridor, maxLength, LabelMode::EXACT, path)) {
+            return true;
+        }
+        if (isSearchCut || !isNodeLimitReached) { // 超时，或不存在不重复经过结点的可行路径
+            return false;
+        }
+        ++greedySearches;
+        return LabelSearch(sid, remainChangeChannelCnt, corridor, maxLength, LabelMode::GREEDY, path);
+    }
+    /**
+     * @brief 松弛搜索找到的路径是否可行：不重复经过边，且在每个结点处换通道的次数不超过剩余次数
+     */
+    static bool IsPathFeasible(const vector<Step>& path, const vector<int>& remainChangeChannelCnt) {
+        for (size_t i = 0; i < path.size(); ++i) {
+            int changeCnt = path[i].IsChannelChanged();
+            for (size_t j = 0; j < i; ++j) {
+                if (path[j].GetEdge() == path[i].GetEdge()) {
+                    return false;
+                }
+                if (path[j].GetStartNode() == path[i].GetStartNode()) {
+                    changeCnt += path[j].IsChannelChanged();
+                }
+            }
+            if (changeCnt > remainChangeChannelCnt[path[i].GetStartNode() - 1]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    /**
+     * @brief 按(结点, 通道)状态做标号搜索，状态表按搜索轮次标记，通道位图在扩展时才计算，
+     *        单次搜索的耗时只与扩展到的范围有关；超过searchEnd时中止搜索，视为寻路失败
+     * @param sid 业务编号
+     * @param remainChangeChannelCnt 各结点剩余的换通道次数
+     * @param corridor 允许扩展的区域，为空时不限制
+     * @param maxLength 路径的最大长度，剩余距离加已走步数超过该值的结点不再生成
+     * @param mode 搜索方式
+     * @param path 找到的路径（从起点到终点）
+     * @return true 寻路成功
+     * @return false 寻路失败
+     */
+    bool LabelSearch(uint16_t sid, const vector<int>& remainChangeChannelCnt, const vector<bool>* corridor,
+                     uint16_t maxLength, LabelMode mode, vector<Step>& path) {
+        const bool elementary = mode != LabelMode::RELAXED; // 只搜索不重复经过结点的路径
+        constexpr double CHANGE_CHANNEL_COST = 0.1; // 换通道的成本
+        const auto& service = s.GetServiceConst(sid);
+        const uint16_t startNode = service.GetStart();
+        const uint16_t endNode = service.GetEnd();
+        const uint16_t useChannelsNum = service.GetUseChannelsNum();
+        const size_t channelsNum = s.GetChannelsNum();
+        auto compare = [] (const AStarNode* lhs, const AStarNode* rhs) {return *rhs < *lhs;};
+        // 每个状态下代价最低和步数最少的结点，用于支配剪枝，下标为 (结点 - 1) * 通道数 + 通道 - 1
+        if (stateRound.size() != s.GetNodesNum() * channelsNum) {
+            stateRound.assign(s.GetNodesNum() * channelsNum, 0);
+            cheapest.resize(stateRound.size());
+            shortest.resize(stateRound.size());
+            expandedRound.assign(stateRound.size(), 0);
+            expanded.resize(stateRound.size());
+            heuristicRound.assign(s.GetNodesNum(), 0);
+            heuristic.resize(s.GetNodesNum());
+            pathMark.assign(s.GetNodesNum(), 0);
+        }
+        ++searchRound;
+        auto getRemainDistance = [&] (uint16_t nid) { // 到终点的距离，每轮搜索中每个结点只查询一次索引
+            if (heuristicRound[nid - 1] != searchRound) {
+                heuristicRound[nid - 1] = searchRound;
+                heuristic[nid - 1] = s.GetNodeDistance(nid, endNode);
+            }
+            return heuristic[nid - 1];
+        };
+        // 精确搜索时node的路径经过的结点已按pathMarkRound标记
+        auto isDominated = [&] (const AStarNode* dominator, const AStarNode& node) {
+            if (dominator->passed > node.passed || dominator->steps > node.steps) {
+                return false;
+            }
+            for (; mode == LabelMode::EXACT && dominator != nullptr; dominator = dominator->f) {
+                if (pathMark[dominator->n - 1] != pathMarkRound) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        vector<AStarNode*> allNodes; // 所有生成的结点，搜索结束后统一释放
+        priority_queue<AStarNode*, vector<AStarNode*>, decltype(compare)> openSet(compare); // 开集，待遍历
+        uint32_t order = 0;
+        AStarNode* root = new AStarNode{startNode, service.GetDefaultChannelStart(), INVALID_ID, nullptr,
+                                        0.0, double(s.GetNodeDistance(startNode, endNode)), 0, order++};
+        allNodes.push_back(root);
+        openSet.push(root);
+        bool isSuccess = false; // 已完成寻路
+        isSearchCut = false;
+        isNodeLimitReached = false;
+        for (uint32_t popped = 0; !openSet.empty(); ++popped) {
+            if (popped % SEARCH_CLOCK_INTERVAL == SEARCH_CLOCK_INTERVAL - 1 && chrono::steady_clock::now() >= searchEnd) {
+                isSearchCut = true;
+                ++deadlineStats.cutSearches;
+                break;
+            }
+            if (mode == LabelMode::EXACT && allNodes.size() > EXACT_SEARCH_NODE_LIMIT) {
+                isNodeLimitReached = true;
+                break;
+            }
+            AStarNode* current = openSet.top(); // 取出代价最小的结点
+            openSet.pop();
+            if (elementary) { // 标记当前结点路径上的结点
+                ++pathMarkRound;
+                for (const AStarNode* node = current; node != nullptr; node = node->f) {
+                    pathMark[node->n - 1] = pathMarkRound;
+                }
+            }
+            if (current->f != nullptr) {
+                // 结点按代价从小到大取出，同一状态下先扩展的结点支配当前结点时不再扩展
+                const size_t state = (current->n - 1) * channelsNum + current->c - 1;
+                if (expandedRound[state] == searchRound && isDominated(expanded[state], *current)) {
+                    continue;
+                }
+                expandedRound[state] = searchRound;
+                expanded[state] = current;
+            }
+            if (current->n == endNode) { // 寻路结束
+                path.clear();
+                for (; current->f != nullptr; current = current->f) {
+                    path.push_back(Step(current->e, current->f->n, current->c, useChannelsNum, IsChannelChanged(current)));
+                }
+                reverse(path.begin(), path.end());
+                isSuccess = true;
+                break;
+            }
+            // 起点可以任选通道，其余结点需要有剩余的换通道次数
+            const bool isAllowChangeChannel = current->f == nullptr || remainChangeChannelCnt[current->n - 1] > 0;
+            for (auto eid : s.GetNodeConst(current->n).GetConnectedEdges()) {
+                const Edge& edge = s.GetEdgeConst(eid);
+                const uint16_t nid = edge.GetAnotherNode(current->n);
+                if (!edge.IsAlive() || (elementary && pathMark[nid - 1] == pathMarkRound)) { // 断边不考虑
+                    continue;
+                }
+                if (corridor != nullptr && !(*corridor)[s.GetRegion(nid)]) { // 走廊外的区域不考虑
+                    continue;
+                }
+                uint16_t remainDis = getRemainDistance(nid);
+                if (remainDis == UINT16_MAX || current->steps + 1 + remainDis > maxLength) {continue;}
+                ChannelMask channels = edge.GetStartChannels(useChannelsNum); // 窗口内通道全部空闲的起始通道
+                if (!isAllowChangeChannel) { // 预算耗尽，只能沿用当前通道
+                    const bool isFree = channels.Test(current->c - 1);
+                    channels = ChannelMask{};
+                    if (isFree) {
+                        channels.Set(current->c - 1);
+                    }
+                }
+                if (elementary) { // 新结点的路径为当前结点的路径加上nid
+                    pathMark[nid - 1] = pathMarkRound;
+                }
+                const size_t stateBase = (nid - 1) * channelsNum;
+                while (channels.Any()) {
+                    const size_t bit = channels.First();
+                    channels.Reset(bit);
+                    const uint8_t cid = bit + 1;
+                    const bool isChanged = current->f != nullptr && cid != current->c;
+                    AStarNode newNode{nid, cid, eid, current,
+                                      current->passed + 1.0 + (isChanged ? CHANGE_CHANNEL_COST : 0.0), double(remainDis),
+                                      uint16_t(current->steps + 1), order};
+                    const size_t state = stateBase + bit;
+                    if (stateRound[state] == searchRound &&
+                        (isDominated(cheapest[state], newNode) || isDominated(shortest[state], newNode))) {
+                        continue;
+                    }
+                    ++order;
+                    AStarNode* node = new AStarNode(newNode);
+                    allNodes.push_back(node);
+                    openSet.push(node);
+                    if (stateRound[state] != searchRound) {
+                        stateRound[state] = searchRound;
+                        cheapest[state] = shortest[state] = node;
+                        continue;
+                    }
+                    if (node->passed < cheapest[state]->passed) {
+                        cheapest[state] = node;
+                    }
+                    if (node->steps < shortest[state]->steps) {
+                        shortest[state] = node;
+                    }
+                }
+                if (elementary) {
+                    pathMark[nid - 1] = 0;
+                }
+            }
+        }
+        for (auto node : allNodes) {
+            delete node;
+        }
+        return isSuccess;
+    }
+    /**
+     * @brief 各结点剩余的换通道次数，本次故障处理完成前老路径仍然占用换通道次数
+     */
+    vector<int> GetRemainChangeChannelCnt() const {
+        vector<int> remainChangeChannelCnt(s.GetNodesNum());
+        for (uint16_t nid = 1; nid <= s.GetNodesNum(); ++nid) {
+            remainChangeChannelCnt[nid - 1] = s.GetNodeConst(nid).GetRemainChangeChannelCnt();
+        }
+        return remainChangeChannelCnt;
+    }
+    /**
+     * @brief 从剩余的换通道次数中扣除路径消耗的次数
+     */
+    static void UseChangeChannelCnt(vector<int>& remainChangeChannelCnt, const vector<Step>& path) {
+        for (const auto& step : path) {
+            if (step.IsChannelChanged()) {
+                --remainChangeChannelCnt[step.GetStartNode() - 1];
+            }
+        }
+    }
+    /**
+     * @brief 搜索结点是否从父结点处换了通道（从起点出发的第一步不算换通道）
+     */
+    template <typename SearchNode>
+    static bool IsChannelChanged(const SearchNode* node) {
+        return node->f != nullptr && node->f->f != nullptr && node->c != node->f->c;
+    }
+    /**
+     * @brief 统计搜索结点的路径上在指定结点处换通道的次数
+     */
+    template <typename SearchNode>
+    static int CountChangeChannel(const SearchNode* node, uint16_t nid) {
+        int cnt = 0;
+        for (; node->f != nullptr; node = node->f) {
+            if (node->f->n == nid && IsChannelChanged(node)) {
+                ++cnt;
+            }
+        }
+        return cnt;
+    }
+    /**
+     * @brief 精确规划：为每个业务枚举少量候选路径，再分支定界选出通道与换通道次数均不冲突、恢复价值最高的组合
+     * @note 候选路径的第一条取贪心（AStar）的结果，因此结果不会比贪心差；其余候选路径与已有的候选路径通道不相交；
+     *       贪心与候选路径的搜索都在试规划中进行，之后撤销；分支定界的结点数超过EXACT_NODE_LIMIT或到达截止时间时提前结束，使用已找到的最优组合与贪心中较好的一个
+     * @param services 受到影响的业务编号
+     * @param output 成功重新规划的业务编号
+     */
+    void Exact(const vector<uint16_t>& services, vector<uint16_t>& output) {
+        const size_t servicesNum = services.size();
+        vector<int> remainChangeChannelCnt = GetRemainChangeChannelCnt();
+        // 候选路径，第一维为业务下标
+        vector<vector<vector<Step>>> candidates(servicesNum);
+        vector<uint16_t> greedyOutput;
+        s.BeginTrial(services);
+        AStar(services, greedyOutput);
+        if (greedyOutput.size() == servicesNum || IsPastDeadline()) { // 贪心全部恢复时即为最优解，超时则直接使用贪心
+            s.CommitTrial();
+            output = greedyOutput;
+            return;
+        }
+        double greedyValue = 0.0;
+        for (auto sid : greedyOutput) {
+            greedyValue += s.GetServiceConst(sid).GetValue();
+        }
+        for (size_t i = 0; i < servicesNum; ++i) {
+            if (find(greedyOutput.begin(), greedyOutput.end(), services[i]) != greedyOutput.end()) {
+                candidates[i].push_back(s.GetServiceConst(services[i]).GetPath());
+            }
+        }
+        s.RollbackTrial();
+        // 依次占用已找到路径的通道（含贪心的路径），迫使后续的候选路径与之前的通道不相交
+        searchEnd = deadline;
+        for (size_t i = 0; i < servicesNum && !IsPastDeadline(); ++i) {
+            const uint16_t sid = services[i];
+            s.BeginTrial({sid});
+            s.HideServicePath(sid);
+            if (!candidates[i].empty()) {
+                s.ResetServicePath(sid, candidates[i][0]);
+            }
+            for (size_t k = 0; k < EXACT_CANDIDATES_NUM; ++k) {
+                vector<Step> path;
+                if (!Search(sid, remainChangeChannelCnt, path)) {
+                    break;
+                }
+                candidates[i].push_back(path);
+                s.ResetServicePath(sid, path);
+            }
+            s.RollbackTrial();
+        }
+        // 候选路径编号及两两之间的通道冲突表
+        vector<pair<size_t, size_t>> index; // (业务下标, 候选下标)
+        vector<vector<size_t>> candidateIndex(servicesNum); // 业务的候选路径在index中的下标
+        for (size_t i = 0; i < servicesNum; ++i) {
+            for (size_t k = 0; k < candidates[i].size(); ++k) {
+                candidateIndex[i].push_back(index.size());
+                index.emplace_back(i, k);
+            }
+        }
+        vector<vector<bool>> conflict(index.size(), vector<bool>(index.size(), false));
+        for (size_t a = 0; a < index.size(); ++a) {
+            for (size_t b = a + 1; b < index.size(); ++b) {
+                if (index[a].first == index[b].first) {
+                    continue;
+                }
+                conflict[a][b] = conflict[b][a] = IsPathConflict(candidates[index[a].first][index[a].second],
+                                                                 candidates[index[b].first][index[b].second]);
+            }
+        }
+        // 上界：剩余业务的价值之和（没有候选路径的业务不计入）
+        vector<double> suffixValue(servicesNum + 1, 0.0);
+        for (size_t i = servicesNum; i > 0; --i) {
+            suffixValue[i - 1] = suffixValue[i] + (candidates[i - 1].empty() ? 0.0 : s.GetServiceConst(services[i - 1]).GetValue());
+        }
+        vector<size_t> chosen; // 当前组合中已选的候选路径在index中的下标
+        vector<size_t> choice(servicesNum, SIZE_MAX), bestChoice(servicesNum, SIZE_MAX);
+        double bestValue = -1.0;
+        size_t nodesCnt = 0;
+        // 深度优先分支定界，每个业务先尝试各候选路径，最后尝试放弃
+        auto branch = [&] (auto&& self, size_t i, double value) -> void {
+            if (++nodesCnt > EXACT_NODE_LIMIT || value + suffixValue[i] <= bestValue) {
+                return;
+            }
+            if (nodesCnt % SEARCH_CLOCK_INTERVAL == 0 && IsPastDeadline()) {
+                nodesCnt = EXACT_NODE_LIMIT; // 超时后不再扩展
+                ++deadlineStats.cutSearches;
+                return;
+            }
+            if (i == servicesNum) {
+                bestValue = value;
+                bestChoice = choice;
+                return;
+            }
+            for (auto c : candidateIndex[i]) {
+                bool isFeasible = true;
+                for (auto o : chosen) {
+                    if (conflict[c][o]) {
+                        isFeasible = false;
+                        break;
+                    }
+                }
+                const vector<Step>& path = candidates[i][index[c].second];
+                for (const auto& step : path) {
+                    if (step.IsChannelChanged() && --remainChangeChannelCnt[step.GetStartNode() - 1] < 0) {
+                        isFeasible = false;
+                    }
+                }
+                if (isFeasible) {
+                    chosen.push_back(c);
+                    choice[i] = c;
+                    self(self, i + 1, value + s.GetServiceConst(services[i]).GetValue());
+                    choice[i] = SIZE_MAX;
+                    chosen.pop_back();
+                }
+                for (const auto& step : path) {
+                    if (step.IsChannelChanged()) {
+                        ++remainChangeChannelCnt[step.GetStartNode() - 1];
+                    }
+                }
+            }
+            self(self, i + 1, value);
+        };
+        branch(branch, 0, 0.0);
+        if (bestValue < greedyValue) { // 分支定界提前结束时不比贪心差：贪心的路径是各业务的第一条候选路径
+            bestValue = greedyValue;
+            for (size_t i = 0; i < servicesNum; ++i) {
+                bestChoice[i] = candidates[i].empty() || find(greedyOutput.begin(), greedyOutput.end(), services[i]) == greedyOutput.end() ?
+                                SIZE_MAX : candidateIndex[i][0];
+            }
+        }
+        LOG("exact: services %lu, candidates %lu, nodes %lu, value %.0f\n", servicesNum, index.size(), nodesCnt, bestValue);
+        // 按最优组合更新场景，未选中的业务恢复老路径
+        for (size_t i = 0; i < servicesNum; ++i) {
+            const uint16_t sid = services[i];
+            s.HideServicePath(sid);
+            if (bestChoice[i] != SIZE_MAX) {
+                s.ResetServicePath(sid, candidates[i][index[bestChoice[i]].second]);
+                output.push_back(sid);
+            }
+        }
+        for (size_t i = 0; i < servicesNum; ++i) {
+            if (bestChoice[i] == SIZE_MAX) {
+                s.RecoverServicePath(services[i], true);
+            }
+        }
+        s.ClearHidedPath();
+    }
+    /**
+     * @brief 两条路径是否在同一条边上使用了重叠的通道
+     */
+    static bool IsPathConflict(const vector<Step>& path1, const vector<Step>& path2) {
+        for (const auto& step1 : path1) {
+            for (const auto& step2 : path2) {
+                if (step1.GetEdge() == step2.GetEdge() &&
+                    step1.GetStartChannel() <= step2.GetEndChannel() &&
+                    step2.GetStartChannel() <= step1.GetEndChannel()) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    PathCache& cache; // 路径缓存，在所有场景间共享
+    Mode mode; // 规划方式
+    chrono::steady_clock::time_point searchEnd = chrono::steady_clock::time_point::max(); // 当前搜索的截止时间
+    bool isSearchCut = false; // 上次搜索是否因超时中止
+    uint32_t rejectedSearches = 0; // 被容量预检拒绝的搜索数
+    bool isNodeLimitReached = false; // 上次搜索是否因结点数超过上限而中止
+    uint32_t exactSearches = 0; // 松弛搜索的路径不可行、退回精确搜索的次数
+    uint32_t greedySearches = 0; // 精确搜索超过结点数上限、退回贪心搜索的次数
+    uint32_t searchRound = 0; // A*搜索轮次
+    vector<uint32_t> stateRound; // 状态表中各状态最后被写入的搜索轮次，与当前轮次不同的状态视为空
+    vector<AStarNode*> cheapest; // 各状态下代价最低的结点
+    vector<AStarNode*> shortest; // 各状态下步数最少的结点
+    vector<uint32_t> expandedRound; // 各状态最后被扩展的搜索轮次
+    vector<uint32_t> pathMark; // 各结点是否在当前结点的路径上（等于pathMarkRound时在）
+    uint32_t pathMarkRound = 0; // 路径标记的轮次，每取出一个结点加一
+    vector<AStarNode*> expanded; // 各状态下最近扩展的结点
+    vector<uint32_t> heuristicRound; // 各结点到终点的距离最后被查询的搜索轮次
+    vector<uint16_t> heuristic; // 各结点到终点的距离
+};
+
+/**
+ * @brief 唐鑫的算法
+ */
+class SolutionTX final : public PlanningSolution {
+public:
+    explicit SolutionTX(const Scene& s) : PlanningSolution(s) {}
+
+private:
+    class ProgramPlan{
+        private:
+            uint16_t businessId; // 业务Id
+            vector<Step> path; // 目前最优解
+            uint16_t score; // 分数
+        public:
+            ProgramPlan(uint16_t businessId) : businessId(businessId){}
+            ProgramPlan(uint16_t businessId, vector<Step> path, uint16_t score) : businessId(businessId), path(path), score(score){};
+            uint16_t GetScore(){return score;}
+            uint16_t GetBusinessId(){return businessId;}
+            vector<Step> GetPath(){return path;}
+            void SetScore(uint16_t score){this->score = score;}
+            void SetPath(vector<Step> path){this->path = path;}
+    };
+    queue<vector<Step>> q;
+    uint16_t n1,n2,n3; // 超参数
+
+
+    static bool scoreCmp(ProgramPlan a, ProgramPlan b){
+        return a.GetScore() > b.GetScore();
+    }
+    /**
+     * @brief 业务比较函数
+     * @param s1 业务1
+     * @param s2 业务2
+     * @return true 在排序时将业务1放在前面
+     * @return false 在排序时将业务2放在前面
+     */
+    bool ServiceCompare(const Service& s1, const Service& s2) const override {
+        return s1.GetValue() > s2.GetValue();
+    }
+        /**
+     * @brief 徐哥BFS的方法
+     * @param b 受到影响的业务编号 
+     * @param vector<Step> 成功重新规划的路径
+     */
+    vector<Step> BFSNew(uint16_t b){
+        
+        const auto& service = s.GetService(b);
+        uint16_t start = service.GetStart();
+        uint16_t end = service.GetEnd();
+        // 这里编号是对的吗？ 编号都是从1开始的 数组会不会小了一个？
+        vector<bool> visited(s.GetNodesNum()+5, false);
+        struct BfsNode {
+            uint16_t n; // 终点
+            uint16_t e; // 抵达终点的边
+            uint16_t startChannel; // 通道起点
+            bool isChange; // 是否变道
+            BfsNode* f; // 父结点
+        };
+        queue<BfsNode*> openSet; // 开集，待遍历
+        queue<BfsNode*> closeSet; // 闭集，已完成遍历
+        openSet.push(new BfsNode{start, INVALID_ID, INVALID_ID, false, nullptr});
+        BfsNode* endNode = nullptr;
+        vector<Step> path;
+        while (!openSet.empty()) { // BFS
+            auto node = openSet.front();
+            openSet.pop();
+            visited[node->n - 1] = true;
+            if (node->n == end) {
+                endNode = node;
+                closeSet.push(node);
+                break;
+            }
+            const vector<uint16_t>& edges = s.GetNodeConst(node->n).GetConnectedEdges();
+            for (auto e : edges) { // 从连接的边中找另一端结点
+                Edge& edge = s.GetEdge(e);
+                bool isChange = false;
+                uint16_t startChannel=-1;
+                bool isOk=false;
+                // 对变通道的考虑
+                if(edge.IsAlive()){
+                    // 优先使用默认通道，被占用时取编号最小的空闲区间
+                    uint8_t channel = service.GetDefaultChannelStart();
+                    if(!edge.CheckChannelsFree(channel, service.GetUseChannelsNum())){
+                        channel = edge.AllocateChannel(service.GetUseChannelsNum());
+                    }
+                    // 与上一步通道不同才算变道，从起点出发的第一步不算
+                    isChange = channel != 0 && node->f != nullptr && channel != node->startChannel;
+                    isOk = channel != 0 && (!isChange || s.GetNode(node->n).GetRemainChangeChannelCnt()>0);
+                    startChannel = channel;
+                }
+                uint16_t nextNode = edge.GetAnotherNode(node->n);
+                if (!visited[nextNode - 1] && isOk) {
+                    openSet.push(new BfsNode{nextNode, e, startChannel, isChange, node});
+                }
+            }
+            closeSet.push(node);
+        }
+        if (endNode) {
+            while (endNode->f != nullptr) {
+                path.push_back(Step(endNode->e, endNode->f->n, endNode->startChannel, service.GetUseChannelsNum(), endNode->isChange));
+                endNode = endNode->f;
+            }
+        }
+        while (!openSet.empty()) {
+            delete openSet.front();
+            openSet.pop();
+        }
+        while (!closeSet.empty()) {
+            delete closeSet.front();
+            closeSet.pop();
+        }
+        if (!path.empty()) {
+            reverse(path.begin(), path.end());
+        }
+        return path;
+    }
+    // 判断业务能否塞入
+    bool PlanCheck(ProgramPlan plan){
+        // 有可能新规划的业务占用了已规划的通道
+    }
+    void Program(vector<ProgramPlan> &programPlans){
+        sort(programPlans.begin(), programPlans.end(), scoreCmp);
+        for(auto plan : programPlans){
+            // 判断能不能放进去 如果能放进去 有点冗余 因为已经判断过了 很冗余啊
+            uint16_t businessId = plan.GetBusinessId();
+            s.HideServicePath(businessId);
+            if(PlanCheck(plan)){
+                
+            }
+        }
+    }
+
+    // 对考虑变道情况的BFS进行测试
+    // 本算法为对service根据价值进行排序，考虑使用变道次数
+    void Planning(const vector<uint16_t>& services, vector<uint16_t>& output) override {
+        vector<ProgramPlan> unfinishPlans;
+        for(auto serviceId : services){
+            // 初始分数计算公式 = value
+            ProgramPlan plan(serviceId, vector<Step>(), s.GetService(serviceId).GetValue());
+            unfinishPlans.push_back(plan);
+        }
+        sort(unfinishPlans.begin(), unfinishPlans.end(), scoreCmp);
+        for(size_t i = 0; i < unfinishPlans.size(); i++){
+            if(IsPastDeadline()){
+                deadlineStats.skippedServices += unfinishPlans.size() - i;
+                break;
+            }
+            ProgramPlan& plan = unfinishPlans[i];
+            s.HideServicePath(plan.GetBusinessId());
+            vector<Step> path = BFSNew(plan.GetBusinessId());
+            if(!path.empty()){
+                s.ResetServicePath(plan.GetBusinessId(), path);
+                output.push_back(plan.GetBusinessId());
+                s.DeleteHidedPath(plan.GetBusinessId());
+            } else {
+                s.RecoverServicePath(plan.GetBusinessId());
+            }
+        }
+    }
+    // 循环优化（暂时未完成)
+    void CyclePlanningTest(const vector<uint16_t>& services, vector<uint16_t>& output) {
+        // 修改这里的结构 感觉可以直接直接用 programPlans 在这里初始化就行了 不要用uint16_t 太奇怪了
+        vector<ProgramPlan> unfinishPlans;
+        for(auto serviceId : services){
+            // 初始分数计算公式 = value
+            ProgramPlan plan(serviceId, vector<Step>(), s.GetService(serviceId).GetValue());
+            unfinishPlans.push_back(plan);
+        }
+        // 循环次数参数
+        int i = 0;
+        while(!unfinishPlans.empty() && i<20){
+            i++;
+            // 先查找路径 得到目前的最优解
+            sort(unfinishPlans.begin(), unfinishPlans.end(), scoreCmp);
+            for(auto it = unfinishPlans.begin(); it != unfinishPlans.end(); it++){
+                ProgramPlan plan = *it;
+                s.HideServicePath(plan.GetBusinessId());
+                Service& service = s.GetService(plan.GetBusinessId());
+                vector<Step> ProgramPath = BFSNew(service.GetId());
+                // TODO 根据上轮BFS的解来找次优解
+                if(!ProgramPath.empty()||plan.GetPath().empty()){
+                    // 规划成功 直接把业务塞进去
+                    s.ResetServicePath(plan.GetBusinessId(), ProgramPath);
+                    output.push_back(plan.GetBusinessId());
+                    s.DeleteHidedPath(plan.GetBusinessId());
+                    unfinishPlans.erase(it);
+                    continue;
+                    // 删除这个plan
+                }else{
+                    // 计算变道次数
+                    // 重新赋值 到下一次循环再说
+                    s.RecoverServicePath(plan.GetBusinessId());
+                    uint16_t changeNum = 0;
+                    for(auto step : ProgramPath){
+                        if(step.GetUseChannelsNum()){
+                            changeNum++;
+                    }
+                    }
+                    // 计算分数
+                    int score = n1 * service.GetValue() - n2 * ProgramPath.size() - n3 * changeNum;
+                    plan.SetScore(score);
+                    plan.SetPath(ProgramPath);
+                }
+            }
+        }
+    }
+
+};
+
+/**
+ * @brief 陈嘉的算法
+ */
+class SolutionCJ final : public PlanningSolution {
+public:
+    explicit SolutionCJ(const Scene& s) : PlanningSolution(s) {}
+
+private:
+    /**
+     * @brief 业务比较函数
+     * @param s1 业务1
+     * @param s2 业务2
+     * @return true 在排序时将业务1放在前面
+     * @return false 在排序时将业务2放在前面
+     */
+    bool ServiceCompare(const Service& s1, const Service& s2) const override {
+        return s1.GetValue() > s2.GetValue();
+    }
+    /**
+     * @brief 规划器
+     * @param services 受到影响的业务编号 
+     * @param output 成功重新规划的业务编号（放入output的业务会自动被设置为复活）
+     */
+    void Planning(const vector<uint16_t>& services, vector<uint16_t>& output) override {
+        
+    }
+};
+
+/**
+ * @brief 组合规划器中各策略的累计表现，在所有场景间共享，用于淘汰长期不胜出的策略
+ */
+class PortfolioStats {
+public:
+    struct Counter {
+        uint32_t wins = 0; // 方案被采用的次数
+        uint32_t finished = 0; // 在截止时间前完成的次数
+        uint32_t late = 0; // 超过截止时间的次数
+        uint32_t invalid = 0; // 方案未通过检查的次数
+        uint32_t busy = 0; // 上次超时仍在运行而被跳过的次数
+        double wonValue = 0.0; // 被采用方案恢复的价值之和
+    };
+
+public:
+    Counter& Get(const string& name) {
+        for (auto& it : counters) {
+            if (it.first == name) {
+                return it.second;
+            }
+        }
+        counters.emplace_back(name, Counter());
+        return counters.back().second;
+    }
+    void LogStats() const {
+#ifdef DEBUG
+        for (const auto& it : counters) {
+            const Counter& c = it.second;
+            LOG_INFO("组合策略[%s]：胜出 %u 完成 %u 超时 %u 无效 %u 跳过 %u 胜出价值 %.0f\n", it.first.c_str(),
+                     c.wins, c.finished, c.late, c.invalid, c.busy, c.wonValue);
+        }
+#endif // DEBUG
+    }
+
+private:
+    vector<pair<string, Counter>> counters; // (策略名, 计数)，按加入顺序
+};
+
+/**
+ * @brief 组合规划器：每次故障把当前场景复制给各个策略并发规划，
+ *        在截止时间内完成且通过检查的方案中取恢复价值最高的提交
+ * @note 首个策略总会等待其完成，保证每次故障都有方案；其他策略超时后在后台继续运行，
+ *       直到完成前的故障中都被跳过。只有首个策略使用路径缓存，各策略之间不共享可变状态
+ */
+class SolutionPortfolio final : public Solution {
+public:
+    static constexpr chrono::milliseconds DEADLINE{100}; // 每次故障的截止时间
+
+public:
+    SolutionPortfolio(const Scene& s, PathCache& cache, PortfolioStats& stats) : Solution(s), stats(stats) {
+        AddMember("XTZ-AStar", new SolutionXTZ(s, cache));
+        AddMember("XTZ-BFS", new SolutionXTZ(s, cache, SolutionXTZ::Mode::BFS));
+        AddMember("TX-BFSNew", new SolutionTX(s));
+    }
+    ~SolutionPortfolio() override {
+        for (auto& member : members) {
+            if (member.running.valid()) {
+                member.running.wait();
+            }
+            delete member.solution;
+        }
+    }
+
+public:
+    /**
+     * @brief 加入策略，组合规划器负责释放
+     * @param name 策略名，用于统计
+     * @param solution 策略
+     */
+    void AddMember(const string& name, PlanningSolution* solution) {
+        members.emplace_back();
+        members.back().name = name;
+        members.back().solution = solution;
+        if (members.size() > 1) { // 首个策略以外的策略在组合的截止时间内给出部分结果
+            solution->SetHandleBudget(DEADLINE);
+        }
+        stats.Get(name); // 先登记，保证统计中的顺序与加入顺序一致
+    }
+    vector<vector<uint16_t>> Handle(const vector<uint16_t>& edges, bool print = true) override {
+        const auto deadline = chrono::steady_clock::now() + DEADLINE;
+        for (auto& member : members) {
+            if (member.running.valid() &&
+                member.running.wait_for(chrono::seconds(0)) != future_status::ready) {
+                ++stats.Get(member.name).busy;
+                member.started = false;
+                continue;
+            }
+            PlanningSolution* solution = member.solution;
+            solution->SetScene(s);
+            member.running = async(launch::async, [solution, edges] () {
+                return solution->Handle(edges, false);
+            });
+            member.started = true;
+        }
+        Member* winner = nullptr;
+        vector<vector<uint16_t>> outputs;
+        double winnerValue = -1.0;
+        for (size_t i = 0; i < members.size(); ++i) {
+            Member& member = members[i];
+            if (!member.started) {
+                continue;
+            }
+            PortfolioStats::Counter& counter = stats.Get(member.name);
+            if (i > 0 && member.running.wait_until(deadline) != future_status::ready) {
+                ++counter.late; // 留在后台运行，完成前不再参与
+                continue;
+            }
+            vector<vector<uint16_t>> result = member.running.get();
+            ++counter.finished;
+            const Scene& scene = member.solution->GetScene();
+            if (!IsPlanValid(scene, result)) {
+                ++counter.invalid;
+                continue;
+            }
+            double value = scene.GetRevivedValue() - s.GetRevivedValue();
+            if (value > winnerValue) { // 价值相同时取靠前的策略
+                winnerValue = value;
+                winner = &member;
+                outputs = move(result);
+            }
+        }
+        if (winner == nullptr) { // 所有方案均无效时不恢复任何业务
+            for (auto eid : edges) {
+                s.Kill(eid);
+            }
+            outputs.assign(edges.size(), vector<uint16_t>());
+        } else {
+            ++stats.Get(winner->name).wins;
+            stats.Get(winner->name).wonValue += winnerValue;
+            s = winner->solution->GetScene();
+        }
+        if (print) {
+            for (const auto& output : outputs) {
+                PrintAns(output);
+            }
+        }
+        return outputs;
+    }
+
+    void LogStats(const string& name = "") const override {
+        for (const auto& member : members) {
+            member.solution->LogStats(name + "[" + member.name + "]");
+        }
+    }
+
+private:
+    struct Member {
+        string name; // 策略名
+        PlanningSolution* solution; // 策略，持有自己的场景副本
+        future<vector<vector<uint16_t>>> running; // 正在进行的规划
+        bool started = false; // 本次故障是否参与
+    };
+
+private:
+    /**
+     * @brief 检查策略的方案：新路径只经过存活的边并占有其通道，不占用其他业务在故障前的通道
+     *        （原路径在本次故障处理完之前仍然占用），且各结点的换通道次数在原路径仍然计数的
+     *        情况下不超过上限（从起点出发的第一步不算换通道）
+     * @param scene 策略规划后的场景
+     * @param outputs 策略输出的各故障边对应的业务编号
+     */
+    bool IsPlanValid(const Scene& scene, const vector<vector<uint16_t>>& outputs) const {
+        vector<int> remain(s.GetNodesNum());
+        for (uint16_t nid = 1; nid <= s.GetNodesNum(); ++nid) {
+            remain[nid - 1] = s.GetNodeConst(nid).GetRemainChangeChannelCnt();
+        }
+        for (const auto& output : outputs) {
+            for (auto sid : output) {
+                const vector<Step>& path = scene.GetServiceConst(sid).GetPath();
+                for (size_t i = 0; i < path.size(); ++i) {
+                    const Step& step = path[i];
+                    const Edge& edge = scene.GetEdgeConst(step.GetEdge());
+                    const Edge& before = s.GetEdgeConst(step.GetEdge());
+                    if (!edge.IsAlive()) {
+                        return false;
+                    }
+                    for (uint8_t c = step.GetStartChannel(); c <= step.GetEndChannel(); ++c) {
+                        if (edge.GetChannel(c) != sid || (before.GetChannel(c) != INVALID_ID && before.GetChannel(c) != sid)) {
+                            return false;
+                        }
+                    }
+                    if (i > 0 && step.GetStartChannel() != path[i - 1].GetStartChannel() &&
+                        --remain[step.GetStartNode() - 1] < 0) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    vector<Member> members; // 参与组合的策略，首个策略总会等待其完成
+    PortfolioStats& stats; // 各策略的累计表现
+};
+
+/**
+ * @brief 回放轨迹的格式
+ * @note 轨迹为uint32_t字序列：文件头(MAGIC, VERSION, 通道数, 字数)之后，输入项与标准输入逐项对应，
+ *       每个故障边之后紧跟该次故障的输出：业务数，再逐个业务为(编号, 路径长度, 边, 起始通道, 终止通道, ...)；
+ *       输入项在int32范围内，-1按0xFFFFFFFF存储
+ */
+struct TraceFormat {
+    static constexpr uint32_t MAGIC = 0x52544348; // "HCTR"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_WORDS_NUM = 4;
+};
+
+/**
+ * @brief 轨迹记录器：运行时记录输入与每次故障的输出
+ * @note 任何一次写入失败都会立即报错，之后不再写入，Close返回false
+ */
+class TraceRecorder {
+public:
+    ~TraceRecorder() {
+        Close();
+    }
+
+public:
+    bool Open(const char* path, uint32_t channelsNum) {
+        file = fopen(path, "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        const uint32_t header[TraceFormat::HEADER_WORDS_NUM] = {TraceFormat::MAGIC, TraceFormat::VERSION, channelsNum, 0};
+        if (fwrite(header, sizeof(uint32_t), TraceFormat::HEADER_WORDS_NUM, file) != TraceFormat::HEADER_WORDS_NUM) {
+            fclose(file);
+            file = nullptr;
+            unlink(path);
+            return false;
+        }
+        return true;
+    }
+    /**
+     * @brief 关闭文件，回填文件头中的字数
+     * @return true 全部内容都已写入
+     */
+    bool Close() {
+        if (file == nullptr) {
+            return !isFailed;
+        }
+        if (!isFailed && (fseek(file, (TraceFormat::HEADER_WORDS_NUM - 1) * sizeof(uint32_t), SEEK_SET) != 0 ||
+                          fwrite(&wordsNum, sizeof(uint32_t), 1, file) != 1)) {
+            Fail();
+        }
+        if (fclose(file) != 0 && !isFailed) { // 缓冲区中的内容在关闭时才写入
+            Fail();
+        }
+        file = nullptr;
+        return !isFailed;
+    }
+    void WriteInput(int x) {
+        Write(uint32_t(x));
+    }
+    /**
+     * @brief 记录一次故障的输出
+     * @param s 处理完故障后的场景
+     * @param output 成功重新规划的业务编号
+     */
+    void WriteOutput(const Scene& s, const vector<uint16_t>& output) {
+        Write(output.size());
+        for (auto sid : output) {
+            const vector<Step>& path = s.GetServiceConst(sid).GetPath();
+            Write(sid);
+            Write(path.size());
+            for (const auto& step : path) {
+                Write(step.GetEdge());
+                Write(step.GetStartChannel());
+                Write(step.GetEndChannel());
+            }
+        }
+    }
+
+private:
+    void Write(uint32_t word) {
+        if (isFailed) {
+            return;
+        }
+        if (fwrite(&word, sizeof(uint32_t), 1, file) != 1) {
+            Fail();
+            return;
+        }
+        ++wordsNum;
+    }
+    void Fail() {
+        isFailed = true;
+        fprintf(stderr, "写入轨迹文件失败：%s\n", strerror(errno));
+    }
+
+private:
+    FILE* file = nullptr;
+    uint32_t wordsNum = 0;
+    bool isFailed = false; // 是否有写入失败
+};
+
+/**
+ * @brief 轨迹回放器：内存映射轨迹文件，按原顺序提供输入并校验每次故障的输出
+ */
+class TraceReplayer {
+public:
+    ~TraceReplayer() {
+        if (words != nullptr) {
+            munmap(const_cast<uint32_t*>(words), size);
+        }
+    }
+
+public:
+    /**
+     * @brief 映射轨迹文件并检查文件头
+     * @return true 成功
+     */
+    bool Open(const char* path) {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || size_t(st.st_size) < TraceFormat::HEADER_WORDS_NUM * sizeof(uint32_t)) {
+            close(fd);
+            return false;
+        }
+        size = st.st_size;
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            return false;
+        }
+        words = static_cast<const uint32_t*>(addr);
+        cur = words + TraceFormat::HEADER_WORDS_NUM;
+        end = cur + words[3];
+        return words[0] == TraceFormat::MAGIC && words[1] == TraceFormat::VERSION &&
+               (TraceFormat::HEADER_WORDS_NUM + words[3]) * sizeof(uint32_t) == size;
+    }
+    uint32_t GetChannelsNum() const {return words[2];}
+    int ReadInput() {
+        return int(Read());
+    }
+    /**
+     * @brief 校验一次故障的输出，不论是否一致都跳过轨迹中记录的整段输出
+     * @param s 处理完故障后的场景
+     * @param output 成功重新规划的业务编号
+     * @return true 与记录一致
+     */
+    bool VerifyOutput(const Scene& s, const vector<uint16_t>& output) {
+        uint32_t cnt = Read();
+        bool same = cnt == output.size();
+        for (uint32_t i = 0; i < cnt; ++i) {
+            uint32_t sid = Read();
+            uint32_t len = Read();
+            const vector<Step>* path = nullptr;
+            if (same && sid == output[i]) {
+                path = &s.GetServiceConst(sid).GetPath();
+            }
+            same = path != nullptr && len == path->size();
+            for (uint32_t j = 0; j < len; ++j) {
+                uint32_t edge = Read(), startChannel = Read(), endChannel = Read();
+                if (same) {
+                    const Step& step = (*path)[j];
+                    same = edge == step.GetEdge() && startChannel == step.GetStartChannel() &&
+                           endChannel == step.GetEndChannel();
+                }
+            }
+            if (!same) {
+                LOG_INFO("回放分歧：第%u个输出业务%u\n", i + 1, sid);
+                cur = SkipOutput(i + 1, cnt);
+                return false;
+            }
+        }
+        return same;
+    }
+    bool IsEnd() const {return cur == end;}
+
+private:
+    uint32_t Read() {
+        ASSERT(cur < end);
+        return cur < end ? *cur++ : uint32_t(-1);
+    }
+    /**
+     * @brief 跳过记录中从第from个业务开始的剩余输出
+     */
+    const uint32_t* SkipOutput(uint32_t from, uint32_t cnt) {
+        for (uint32_t i = from; i < cnt && cur + 2 <= end; ++i) {
+            uint32_t len = cur[1];
+            cur = min(end, cur + 2 + size_t(len) * 3);
+        }
+        return cur;
+    }
+
+private:
+    const uint32_t* words = nullptr;
+    const uint32_t* cur = nullptr;
+    const uint32_t* end = nullptr;
+    size_t size = 0;
+};
+
+/**
+ * @brief 主函数
+ * @param argc
+ * @param argv 依次为log输出位置、每条边的通道数，其后为可选的参数对：
+ *             "record 轨迹文件"、"replay 轨迹文件"、"batch 批大小"、"image 场景镜像文件"、"portfolio 1"
+ * @return int
+ */
+int main(int argc, char **argv) {
+    /* LOG初始化 */////////////////////////////////////////////////////////////////////////////////////////////////
+    LOG_INIT(argc > 1 ? argv[1] : "log/log.txt"); // 程序运行时第一个参数传递log输出位置
+    LOG_LINE();
+    LOG_INFO("编译时间[%s %s]\n", __DATE__, __TIME__)
+    LOG_LINE();
+
+    /* 可选参数 *////////////////////////////////////////////////////////////////////////////////////////////////////
+    // "record 轨迹文件"时记录输入与输出，"replay 轨迹文件"时从轨迹回放并校验输出；
+    // "batch 批大小"时每次读入至多批大小条故障边联合规划，要求故障序列预先完整给出（交互评测时须为1）；
+    // "image 场景镜像文件"时镜像与初始环境输入一致则直接加载，否则构建场景后保存镜像；
+    // "portfolio 1"时使用组合规划器，缺省只使用徐天泽的算法；
+    // 记录与回放时只使用徐天泽的算法且不限制规划时间，输出与运行速度无关，回放可以复现
+    unique_ptr<TraceRecorder> recorder; // 提前返回时也会析构，回填轨迹文件头
+    unique_ptr<TraceReplayer> replayer;
+    // 程序运行时第二个参数传递每条边的通道数，缺省为默认通道数
+    uint32_t channelsNum = Edge::DEFAULT_CHANNELS_NUM;
+    if (argc > 2) {
+        char* end = nullptr;
+        long value = strtol(argv[2], &end, 10);
+        if (end == argv[2] || *end != '\0' || value < 1 || value > Edge::MAX_CHANNELS_NUM) {
+            fprintf(stderr, "通道数%s无效，应为1~%u的整数\n", argv[2], unsigned(Edge::MAX_CHANNELS_NUM));
+            return 1;
+        }
+        channelsNum = value;
+    }
+    size_t batchSize = 1;
+    const char* imagePath = nullptr;
+    bool usePortfolio = false;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        const string option = argv[i];
+        if (option == "record") {
+            recorder.reset(new TraceRecorder());
+            if (!recorder->Open(argv[i + 1], channelsNum)) {
+                fprintf(stderr, "无法创建轨迹文件%s\n", argv[i + 1]);
+                return 1;
+            }
+        } else if (option == "replay") {
+            replayer.reset(new TraceReplayer());
+            if (!replayer->Open(argv[i + 1])) {
+                fprintf(stderr, "无法打开轨迹文件%s或格式错误\n", argv[i + 1]);
+                return 1;
+            }
+            channelsNum = replayer->GetChannelsNum();
+            if (channelsNum < 1 || channelsNum > Edge::MAX_CHANNELS_NUM) {
+                fprintf(stderr, "轨迹文件%s中的通道数%u无效\n", argv[i + 1], channelsNum);
+                return 1;
+            }
+        } else if (option == "batch") {
+            batchSize = max(1, atoi(argv[i + 1]));
+        } else if (option == "image") {
+            imagePath = argv[i + 1];
+        } else if (option == "portfolio") {
+            usePortfolio = atoi(argv[i + 1]) != 0;
+        }
+    }
+    if (replayer != nullptr) {
+        batchSize = 1; // 轨迹中故障边与输出交替存放，回放逐边校验
+    }
+    const bool isTraced = recorder != nullptr || replayer != nullptr; // 记录或回放
+    if (isTraced) {
+        usePortfolio = false; // 组合规划器按墙钟时间取舍各策略的方案，结果无法复现
+    }
+    // 读取一个输入项：回放时从轨迹读取，否则从标准输入读取，记录时同时写入轨迹
+    auto read = [&] (bool record = true) -> int {
+        if (replayer != nullptr) {
+            return replayer->ReadInput();
+        }
+        int x = -1;
+        if (scanf("%d", &x) != 1) {
+            x = -1;
+        }
+        if (recorder != nullptr && record) {
+            recorder->WriteInput(x);
+        }
+        return x;
+    };
+
+    /* 变量定义 *//////////////////////////////////////////////////////////////////////////////////////////////////
+    Scene original(channelsNum); // 初始场景
+    PathCache pathCache; // 路径缓存，在所有场景间共享
+    PortfolioStats portfolioStats; // 组合规划器中各策略的累计表现
+
+    /* 初始环境输入 *///////////////////////////////////////////////////////////////////////////////////////////////
+    // 先读入全部初始环境输入项，场景镜像与这些输入项一致时直接加载镜像，否则逐项构建场景
+    vector<int> baseInput; // 初始环境输入项
+    auto readBase = [&] () -> int {
+        baseInput.push_back(read());
+        return baseInput.back();
+    };
+    int N = readBase(), M = readBase();
+    for (int i = 0; i < N + 2 * M; ++i) {
+        readBase();
+    }
+    int J = readBase();
+    for (int i = 0; i < J; ++i) {
+        readBase();
+        readBase();
+        int S = readBase();
+        for (int j = 0; j < 3 + S; ++j) {
+            readBase();
+        }
+    }
+    const uint64_t inputHash = HashWords(reinterpret_cast<const uint32_t*>(baseInput.data()), baseInput.size(),
+                                         HashWords(&channelsNum, 1));
+#ifdef DEBUG
+    auto initStart = chrono::steady_clock::now(); // 初始化开始时间，只用于日志
+#endif // DEBUG
+    if (imagePath != nullptr && original.LoadImage(imagePath, inputHash)) {
+        LOG_INFO("加载场景镜像%s\n", imagePath);
+    } else {
+        size_t pos = 0;
+        auto next = [&] () -> int {return baseInput[pos++];};
+        N = next(), M = next();
+        for (int i = 0; i < N; ++i) {
+            int Pi = next();
+            original.AddNode(Pi);
+        }
+        for (int i = 0; i < M; ++i) {
+            int ui = next(), vi = next();
+            if (ui < vi) {
+                original.AddEdge(ui, vi);
+            } else {
+                original.AddEdge(vi, ui);
+            }
+        }
+        original.CreateDistanceIndex();
+        original.CreatePartition(Scene::REGION_NODES_NUM);
+        J = next();
+        for (int i = 0; i < J; ++i) {
+            int Src = next(), Snk = next(), S = next(), L = next(), R = next();
+            long V = next();
+            if (L < 1 || L > R || uint32_t(R) > channelsNum) {
+                fprintf(stderr, "业务%d占用的通道%d~%d超出通道数%u\n", i + 1, L, R, channelsNum);
+                return 1;
+            }
+            uint8_t useChannelsNum = R - L + 1;
+            original.AddService(Src, Snk, double(V), L, useChannelsNum);
+            for (int j = 0; j < S; ++j) {
+                int ei = next();
+                original.AddServiceStep(i + 1, ei);
+            }
+        }
+        if (imagePath != nullptr && !original.SaveImage(imagePath, inputHash)) {
+            fprintf(stderr, "无法保存场景镜像%s\n", imagePath);
+        }
+    }
+    LOG_INFO("初始化用时 %.3fs\n", chrono::duration<double>(chrono::steady_clock::now() - initStart).count());
+    LOG_INFO("距离索引：结点 %lu 标签 %lu\n", original.GetNodesNum(), original.GetDistanceIndexSize());
+#ifdef DEBUG
+    double initValue = original.GetValue(); // 初始状态业务总价值
+    double finalScore = 0.0; // 最终得分
+#endif // DEBUG
+
+    /* 交互部分 *//////////////////////////////////////////////////////////////////////////////////////////////////
+    uint32_t replayedFailures = 0, divergences = 0; // 回放的故障数与输出不一致的故障数
+    auto replayStart = chrono::steady_clock::now();
+    int T = read();
+    for (int i = 0; i < T; ++i) {
+        LOG_INFO("场景[%3d]###########################################################################\n", i + 1);
+        Solution* s = nullptr;
+        if (usePortfolio) {
+            s = new SolutionPortfolio(original, pathCache, portfolioStats);
+        } else {
+            auto xtz = new SolutionXTZ(original, pathCache);
+            if (isTraced) {
+                xtz->DisableDeadline();
+            }
+            s = xtz;
+        }
+        // auto s{new SolutionTX(original)};
+        // auto s{new SolutionCJ(original)};
+        bool scenarioEnd = false;
+        while (!scenarioEnd) {
+            vector<uint16_t> edges; // 本批故障边
+            while (edges.size() < batchSize) {
+                int e_failed = read(false); // 故障边在输出之前写入轨迹
+                if (e_failed == -1) {
+                    scenarioEnd = true;
+                    break;
+                }
+                edges.push_back(e_failed);
+            }
+            if (edges.empty()) {
+                break;
+            }
+            vector<vector<uint16_t>> outputs = s->Handle(edges, replayer == nullptr);
+            LOG_INFO("故障边%u：存活价值 %.0f\n", edges.back(), s->GetValue());
+            for (size_t j = 0; j < edges.size(); ++j) {
+                if (recorder != nullptr) {
+                    recorder->WriteInput(edges[j]);
+                    recorder->WriteOutput(s->GetScene(), outputs[j]);
+                }
+                if (replayer != nullptr) {
+                    ++replayedFailures;
+                    if (!replayer->VerifyOutput(s->GetScene(), outputs[j])) {
+                        ++divergences;
+                        LOG_INFO("回放分歧：场景%d 边%u\n", i + 1, edges[j]);
+                        printf("divergence: scenario %d failure %u edge %u\n", i + 1, replayedFailures, edges[j]);
+                    }
+                }
+            }
+        }
+        if (recorder != nullptr) {
+            recorder->WriteInput(-1);
+        }
+#ifdef DEBUG
+        double score = s->GetValue() * 10000.0 / initValue; // 本场景得分
+        LOG_INFO("得分：%.0f\n", score);
+        finalScore += score;
+#endif // DEBUG
+        LOG_INFO("价值：断开 %.0f 恢复 %.0f 净损失 %.0f\n", s->GetScene().GetKilledValue(),
+                 s->GetScene().GetRevivedValue(), s->GetScene().GetKilledValue() - s->GetScene().GetRevivedValue());
+        s->LogStats();
+        pathCache.LogStats();
+        portfolioStats.LogStats();
+        delete s;
+    }
+    original.DeleteDistanceIndex(); // 释放内存
+    original.DeletePartition();
+    if (replayer != nullptr) {
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - replayStart).count();
+        printf("replay: scenarios %d failures %u divergences %u trailing %s time %.3fs\n", T, replayedFailures,
+               divergences, replayer->IsEnd() ? "no" : "yes", seconds);
+        if (!replayer->IsEnd()) {
+            ++divergences;
+        }
+    }
+    if (recorder != nullptr && !recorder->Close()) {
+        return 1;
+    }
+
+    /* LOG输出 *//////////////////////////////////////////////////////////////////////////////////////////////////
+    LOG_LINE();
+#ifdef DEBUG
+    LOG_INFO("总分：%.0f\n", finalScore);
+#endif // DEBUG
+
+    return divergences == 0 ? 0 : 1;
 }
\ No newline at end of file